@@ -0,0 +1,48 @@
+#!/bin/bash
+
+# usage:
+#   bench.sh [-s SUBPACK] [-t TOOL] [-f filter] [-o results.txt] [-b baseline.txt] [-m min_ms]
+#   - s: subpack option from pack_config.sh to enable (eg. ULTRA)
+#   - t: program in tools/cpu to build and run instead of bench (eg. hash)
+#   - other options are passed to the benchmark binary
+
+CXX=${CXX:-g++}
+CXXFLAGS="-std=c++17 -O2 -fsingle-precision-constant -Wall -Wextra -Wno-unused-parameter"
+
+SRC_DIR=tools/cpu
+OUT_DIR=build/cpu
+INCLUDE_DIR=$OUT_DIR/include
+
+DEFINES=""
+TOOL="bench"
+BENCH_ARGS=()
+while [ $# -gt 0 ]; do
+  if [ "$1" == "-s" ] && [ -n "$2" ]; then
+    DEFINES+="-D$2 "
+    shift
+  elif [ "$1" == "-t" ] && [ -n "$2" ]; then
+    TOOL="$2"
+    shift
+  else
+    BENCH_ARGS+=("$1")
+  fi
+  shift
+done
+
+# copy include/newb, turning GLSL out/inout params into C++ references
+rm -rf $INCLUDE_DIR
+mkdir -p $INCLUDE_DIR
+cp -r include/newb $INCLUDE_DIR/
+tools/generate.sh $INCLUDE_DIR || exit 1
+sed -i -E 's/\b(inout|out)\s+(highp\s+|mediump\s+|lowp\s+)?(float|int|bool|vec[234]|mat[234])\s+/\3 \&/g' $INCLUDE_DIR/newb/functions/*.h
+
+if [ "$TOOL" == "bench" ]; then
+  # terrainVertex is a hand copy of the RenderChunk vertex shader
+  python3 tools/bench_sync.py $DEFINES || exit 1
+fi
+
+echo ">> Compiling $OUT_DIR/$TOOL ${DEFINES:+($DEFINES)}"
+# extra translation units of a tool: $TOOL.*.cpp
+$CXX $CXXFLAGS $DEFINES -I$INCLUDE_DIR -I$SRC_DIR $SRC_DIR/$TOOL.cpp $(ls $SRC_DIR/$TOOL.*.cpp 2>/dev/null) -o $OUT_DIR/$TOOL || exit 1
+
+$OUT_DIR/$TOOL "${BENCH_ARGS[@]}"
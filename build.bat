@@ -3,7 +3,7 @@
 set MBT=env\bin\MaterialBinTool-0.8.2-native-image.exe
 set SHADERC=env\bin\shaderc.exe
 
-set MBT_ARGS=--compile --shaderc %SHADERC% --include include/
+set MBT_ARGS=--compile --shaderc %SHADERC%
 
 set DATA_VER=1.20.0
 set DATA_DIR=data/%DATA_VER%
@@ -12,12 +12,16 @@ set MATERIALS_DIR=materials
 
 set MATERIALS=
 set TARGETS=
+set INCLUDE_DIR=include
+set OUTPUT_DIR=
 set ARG_MODE=
 :loop_args
   if "%1" == "" goto :end_args
   if "%1" == "-p" goto :set_arg
   if "%1" == "-t" goto :set_arg
   if "%1" == "-m" goto :set_arg
+  if "%1" == "-i" goto :set_arg
+  if "%1" == "-o" goto :set_arg
 
   if "%ARG_MODE%" == "" (
     goto :next_arg
@@ -34,6 +38,14 @@ set ARG_MODE=
     set THREADS=%1
     goto :next_arg
   )
+  if "%ARG_MODE%" == "-i" (
+    set INCLUDE_DIR=%1
+    goto :next_arg
+  )
+  if "%ARG_MODE%" == "-o" (
+    set OUTPUT_DIR=%1
+    goto :next_arg
+  )
 :set_arg
     set ARG_MODE=%1
 :next_arg
@@ -53,7 +65,7 @@ if "%THREADS%" == "" (
   set THREADS=%NUMBER_OF_PROCESSORS%
 )
 
-set MBT_ARGS=%MBT_ARGS% --threads %THREADS%
+set MBT_ARGS=%MBT_ARGS% --include %INCLUDE_DIR%/ --threads %THREADS%
 
 for %%f in (%MBT%) do echo %%~nxf 
 for %%p in (%TARGETS%) do (
@@ -62,7 +74,11 @@ for %%p in (%TARGETS%) do (
   if exist %DATA_DIR%\%%p (
     for /d %%s in (%MATERIALS%) do (
       echo  - %%s
-      %MBT% %MBT_ARGS% --output %BUILD_DIR%\%%p --data %DATA_DIR%\%%p\%%~nxs %%s
+      if "%OUTPUT_DIR%" == "" (
+        %MBT% %MBT_ARGS% --output %BUILD_DIR%\%%p --data %DATA_DIR%\%%p\%%~nxs %%s
+      ) else (
+        %MBT% %MBT_ARGS% --output %OUTPUT_DIR% --data %DATA_DIR%\%%p\%%~nxs %%s
+      )
     )
   ) else (
     echo Error: %DATA%\%%p not found
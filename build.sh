@@ -6,23 +6,46 @@ MBT_JAR="java -jar ${MBT_JAR_FILES[0]}"
 SHADERC=env/bin/shaderc
 LIB_DIR=env/lib
 
-MBT_ARGS="--compile --shaderc $SHADERC --include include/"
+MBT_ARGS="--compile --shaderc $SHADERC"
 
 DATA_VER="1.20.0"
 DATA_DIR=data/$DATA_VER
 BUILD_DIR=build
+CACHE_DIR=$BUILD_DIR/.cache
+# compiled materials kept per material and platform, about 3 builds of
+# the default pack and every subpack, older ones are deleted
+CACHE_KEEP=32
 MATERIAL_DIR=materials
+INCLUDE_DIR=include
+WHITELIST=whitelist.json
+# materials -b compiles at once in its java process, raise only after -b -v
+# found the batch output byte-identical to the per-process build
+BATCH_WORKERS=1
 
 TARGETS=""
 MATERIALS=""
+OUTPUT_DIR=""
+JOB_LIST=""
+USE_CACHE=1
+BATCH=0
+VERIFY=0
 
 ARG_MODE=""
 for t in "$@"; do
   if [ "${t:0:1}" == "-" ]; then
     # mode
     OPT=${t:1}
-    if [[ "$OPT" =~ ^[pmt]$ ]]; then
+    if [[ "$OPT" =~ ^[pmtiol]$ ]]; then
       ARG_MODE=$OPT
+    elif [ "$OPT" == "f" ]; then
+      # force rebuild, ignore cache
+      USE_CACHE=0
+    elif [ "$OPT" == "b" ]; then
+      # compile everything in one java process
+      BATCH=1
+    elif [ "$OPT" == "v" ]; then
+      # with -b, compile the batch again one process per material and compare
+      VERIFY=1
     else
       echo "Invalid option: $t"      
       exit 1
@@ -36,6 +59,15 @@ for t in "$@"; do
   elif [ "$ARG_MODE" == "t" ]; then
     # mbt threads
     THREADS="$t"
+  elif [ "$ARG_MODE" == "i" ]; then
+    # include dir (eg. generated per subpack by pack.sh)
+    INCLUDE_DIR=$(realpath -m --relative-to=. $t)
+  elif [ "$ARG_MODE" == "o" ]; then
+    # output dir (default build/<platform>)
+    OUTPUT_DIR="${t%/}"
+  elif [ "$ARG_MODE" == "l" ]; then
+    # job list, one "<material> <include dir> <output dir>" per line (eg. written by pack.sh)
+    JOB_LIST="$t"
   fi
   shift
 done
@@ -54,18 +86,263 @@ if [ -z "$THREADS" ]; then
   THREADS=$(nproc --all)
 fi
 
+# headers generated from config.h (tools/generate.sh) go to a copy of the include dir
+# pack.sh passes include dirs it generated already, with -i or a job list
+if [ -z "$JOB_LIST" ] && [ "$INCLUDE_DIR" == "include" ]; then
+  INCLUDE_DIR=$BUILD_DIR/include/base
+  rm -rf $INCLUDE_DIR
+  mkdir -p $INCLUDE_DIR
+  cp -r include/* $INCLUDE_DIR/
+  tools/generate.sh $INCLUDE_DIR || exit 1
+fi
+
+# cache key inputs that are the same for every material
+TOOL_ID="${MBT_JAR_FILES[0]##*/} shaderc:$(sha256sum < $SHADERC 2> /dev/null | cut -c1-16) args:$MBT_ARGS"
+
 MBT_ARGS+=" --threads $THREADS"
 
+# materials to build for each platform: "<material> <include dir> <output dir>"
+BUILD_LIST=()
+if [ -n "$JOB_LIST" ]; then
+  mapfile -t BUILD_LIST < $JOB_LIST
+else
+  for s in $MATERIALS; do
+    BUILD_LIST+=("$s $INCLUDE_DIR $OUTPUT_DIR")
+  done
+fi
+
+# prints "file <path> <hash>" for a source and everything it includes
+# paths are relative to the include dir, so identical variants share cache entries
+declare -A SEEN
+hash_includes() {
+  local file=$1 inc path
+  if [ -n "${SEEN[$file]}" ]; then
+    return
+  fi
+  SEEN[$file]=1
+  echo "file ${file#$INCLUDE_DIR/} $(sha256sum < $file | cut -c1-16)"
+  for inc in $(sed -n -E 's/^\s*#\s*include\s*[<"]([^>"]+)[>"].*/\1/p' $file); do
+    # bgfx_shader.sh and other tool headers are covered by TOOL_ID
+    for path in ${file%/*}/$inc $INCLUDE_DIR/$inc; do
+      if [ -f "$path" ]; then
+        hash_includes $(realpath -m --relative-to=. $path)
+        break
+      fi
+    done
+  done
+}
+
+# everything a compiled material depends on, one input per line
+material_manifest() {
+  local data=$1 s=$2 f
+  SEEN=()
+  echo "tool $TOOL_ID"
+  for f in $(find $s -type f | sort); do
+    hash_includes $f
+  done
+  if [[ "$data" == $BUILD_DIR/.data/* ]]; then
+    # pruned, the vanilla variants are merged back by the tool
+    echo "tool prune_data.py $(sha256sum < tools/prune_data.py | cut -c1-16)"
+  fi
+  # the data dir and the vanilla material.bin next to it, not its sibling materials
+  for f in $(find "$data" "$data.material.bin" -type f 2> /dev/null | sort); do
+    echo "data ${f#${data%/*}/} $(sha256sum < $f | cut -c1-16)"
+  done
+}
+
+# data of a material without the permutations the whitelist drops
+# pruned copies are per process, parallel builds of other variants use the same material
+pruned_data() {
+  local data=$1 out=$BUILD_DIR/.data/$$/$1
+  if [ -d "$data" ] && [ -f "$WHITELIST" ] && grep -q "\"${data##*/}\"" $WHITELIST; then
+    # with the vanilla material.bin next to it, for vanilla_fallback and the cache key
+    python3 tools/prune_data.py $data $out -w $WHITELIST >&2 && cp $data.material.bin $out.material.bin && data=$out
+  fi
+  echo $data
+}
+
+# puts the vanilla shaders of the variants the whitelist dropped back into a compiled material
+vanilla_fallback() {
+  local out=$1 data=$2 dir=$BUILD_DIR/.data/$$/fallback m=${1##*/}
+  local name=${m%.material.bin}
+  rm -rf $dir
+  mkdir -p $dir/vanilla $dir/compiled
+  cp $data.material.bin $dir/vanilla/$m && mv $out $dir/compiled/ || return 1
+  $MBT_JAR --unpack $dir/vanilla/$m > /dev/null && $MBT_JAR --unpack $dir/compiled/$m > /dev/null || return 1
+  rm $dir/vanilla/$m $dir/compiled/$m
+  python3 tools/prune_data.py $dir/compiled $dir/$name -w $WHITELIST -m $name -f $dir/vanilla || return 1
+  $MBT_JAR --repack $dir/$name --output $dir > /dev/null && mv $dir/$m $out
+}
+
+# caches a compiled material, or drops its pending manifest if compilation failed
+# status: exit status of MaterialBinTool, its output is not trusted after an error
+store_cache() {
+  local status=$1 out=$2 cached=$3 last=$4 vanilla=$5
+  if [ "$status" != 0 ]; then
+    echo "Error: MaterialBinTool failed on ${out##*/} (exit $status)"
+    rm -f $out
+    FAILED=1
+  fi
+  if [ -f "$out" ] && [ -n "$vanilla" ]; then
+    echo "   $(basename $out): $(( $(stat -c %s $out)/1024 )) KB compiled from the whitelisted variants"
+    vanilla_fallback $out $vanilla || rm -f $out
+  fi
+  if [ -f "$out" ]; then
+    cp $out $cached
+    echo "   $(basename $out): $(( $(stat -c %s $out)/1024 )) KB"
+    mv $last.new $last
+    evict_cache $cached
+  else
+    rm -f $last.new
+  fi
+}
+
+# deletes all but the CACHE_KEEP most recently used entries of a material
+evict_cache() {
+  ls -t ${1%-*}-*.material.bin | tail -n +$((CACHE_KEEP+1)) | xargs -r rm -f
+}
+
+now_ms() {
+  echo $(( $(date +%s%N)/1000000 ))
+}
+
+if [ $BATCH == 1 ]; then
+  BATCH_FILE=$BUILD_DIR/.batch/jobs-$$.txt
+  mkdir -p ${BATCH_FILE%/*}
+  rm -f $BATCH_FILE $BATCH_FILE.done
+fi
+PENDING=()
+LAUNCHES=0
+COMPILE_MS=0
+FAILED=0
+
 echo "${MBT_JAR##*/}"
 for p in $TARGETS; do
   echo "----------------------------------------------"
   echo ">> Building materials - $p $DATA_VER:"
   if [ -d "$DATA_DIR/$p" ]; then
-    for s in $MATERIALS; do
-      echo " - $s"
-      LD_LIBRARY_PATH=$LIB_DIR $MBT_JAR $MBT_ARGS --output $BUILD_DIR/$p --data $DATA_DIR/$p/${s##*/} $s -m
+    mkdir -p $CACHE_DIR/$p
+    for job in "${BUILD_LIST[@]}"; do
+      read -r s INCLUDE_DIR OUT_DIR <<< "$job"
+      OUT_DIR=${OUT_DIR:-$BUILD_DIR/$p}
+      mkdir -p $OUT_DIR
+      M_NAME=${s##*/}
+      OUT_FILE=$OUT_DIR/$M_NAME.material.bin
+      DATA=$(pruned_data $DATA_DIR/$p/$M_NAME)
+      # pruned data needs the vanilla variants put back after compiling
+      VANILLA=""
+      if [ "$DATA" != "$DATA_DIR/$p/$M_NAME" ]; then
+        VANILLA=$DATA
+      fi
+      MANIFEST=$(material_manifest $DATA $s)
+      KEY=$(sha256sum <<< "$MANIFEST" | cut -c1-16)
+      CACHED=$CACHE_DIR/$p/$M_NAME-$KEY.material.bin
+      # last build of this material with this include dir, for the miss reason
+      LAST=$CACHE_DIR/$p/$M_NAME.${INCLUDE_DIR//\//_}.manifest
+
+      if [ $USE_CACHE == 1 ] && [ -f "$CACHED" ]; then
+        echo " - $s: hit $KEY"
+        cp $CACHED $OUT_FILE
+        # most recently used, evict_cache keeps it
+        touch $CACHED
+        continue
+      fi
+
+      if [ $USE_CACHE == 0 ]; then
+        REASON="forced"
+      elif [ -f "$LAST" ]; then
+        # inputs that differ from the last build of this material
+        REASON="changed: $(diff <(echo "$MANIFEST") $LAST | sed -n -E 's/^< (file|data|tool) ([^ ]*).*/\2/p' | paste -sd ' ')"
+      else
+        REASON="not cached"
+      fi
+      echo " - $s: miss $KEY ($REASON)"
+
+      rm -f $OUT_FILE
+      echo "$MANIFEST" > $LAST.new
+      ARGS="$MBT_ARGS --include $INCLUDE_DIR/ --output $OUT_DIR --data $DATA $s -m"
+      if [ $BATCH == 1 ]; then
+        echo "$ARGS" >> $BATCH_FILE
+        PENDING+=("$OUT_FILE $CACHED $LAST $VANILLA")
+      else
+        START=$(now_ms)
+        LD_LIBRARY_PATH=$LIB_DIR $MBT_JAR $ARGS
+        STATUS=$?
+        COMPILE_MS=$(( COMPILE_MS + $(now_ms) - START ))
+        LAUNCHES=$((LAUNCHES+1))
+        store_cache $STATUS $OUT_FILE $CACHED $LAST $VANILLA
+      fi
     done
   else
     echo "Error: $DATA_DIR/$p not found"
   fi
 done
+
+if [ ${#PENDING[@]} -gt 0 ]; then
+  echo "----------------------------------------------"
+  echo ">> Compiling ${#PENDING[@]} materials in one java process ($BATCH_WORKERS workers)"
+  START=$(now_ms)
+  LD_LIBRARY_PATH=$LIB_DIR java -cp ${MBT_JAR_FILES[0]} tools/mbt/BatchCompile.java -j $BATCH_WORKERS $BATCH_FILE
+  BATCH_MS=$(( $(now_ms) - START ))
+  echo ">> compile: $BATCH_MS ms wall for ${#PENDING[@]} materials in one java process"
+
+  # jobs listed in the done file ended without an error
+  mapfile -t BATCH_ARGS < $BATCH_FILE
+  BATCH_STATUS=()
+  for ((i=0; i<${#PENDING[@]}; i+=1)); do
+    grep -qx "$i" $BATCH_FILE.done 2>/dev/null
+    BATCH_STATUS[i]=$?
+  done
+  if [ "$(tail -n 1 $BATCH_FILE.done 2>/dev/null)" != "all" ]; then
+    # java exited early, build the jobs it did not finish one material at a time
+    echo ">> Batch did not finish, compiling remaining materials separately"
+    for ((i=0; i<${#PENDING[@]}; i+=1)); do
+      read -r OUT_FILE CACHED LAST VANILLA <<< "${PENDING[i]}"
+      if [ ${BATCH_STATUS[i]} != 0 ]; then
+        rm -f $OUT_FILE
+        LD_LIBRARY_PATH=$LIB_DIR $MBT_JAR ${BATCH_ARGS[i]}
+        BATCH_STATUS[i]=$?
+      fi
+    done
+  fi
+
+  if [ $VERIFY == 1 ]; then
+    # the same jobs, one java process each, into a side dir
+    echo ">> Verifying the batch against one java process per material"
+    VERIFY_DIR=$BUILD_DIR/.batch/verify-$$
+    START=$(now_ms)
+    for ((i=0; i<${#PENDING[@]}; i+=1)); do
+      read -r OUT_FILE CACHED LAST VANILLA <<< "${PENDING[i]}"
+      mkdir -p $VERIFY_DIR/$i
+      ARGS=$(sed "s| --output [^ ]* | --output $VERIFY_DIR/$i |" <<< "${BATCH_ARGS[i]}")
+      LD_LIBRARY_PATH=$LIB_DIR $MBT_JAR $ARGS > /dev/null 2>&1
+    done
+    SINGLE_MS=$(( $(now_ms) - START ))
+    SAME=0
+    for ((i=0; i<${#PENDING[@]}; i+=1)); do
+      read -r OUT_FILE CACHED LAST VANILLA <<< "${PENDING[i]}"
+      if cmp -s $OUT_FILE $VERIFY_DIR/$i/${OUT_FILE##*/}; then
+        SAME=$((SAME+1))
+      else
+        echo " - $OUT_FILE: batch output differs"
+      fi
+    done
+    rm -rf $VERIFY_DIR
+    echo ">> verify: $SAME of ${#PENDING[@]} identical, batch $BATCH_MS ms, one process each $SINGLE_MS ms (wall)"
+    if [ $SAME != ${#PENDING[@]} ]; then
+      echo "Error: batch output differs, keep BATCH_WORKERS=1 or build without -b"
+      FAILED=1
+    fi
+  fi
+
+  for ((i=0; i<${#PENDING[@]}; i+=1)); do
+    store_cache ${BATCH_STATUS[i]} ${PENDING[i]}
+  done
+  rm -f $BATCH_FILE $BATCH_FILE.done
+elif [ $LAUNCHES -gt 0 ]; then
+  echo "----------------------------------------------"
+  echo ">> compile: $COMPILE_MS ms wall for $LAUNCHES materials, one java process each"
+fi
+
+rm -rf $BUILD_DIR/.data/$$
+exit $FAILED
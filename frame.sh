@@ -0,0 +1,55 @@
+#!/bin/bash
+
+# Offscreen frame time of a built pack under Mesa llvmpipe (run report.sh first)
+# usage:
+#   frame.sh -p Android -o build/frame.tsv      # save table
+#   frame.sh -p Android -b build/frame.tsv      # diff against saved table
+#   frame.sh -p Android -f RenderChunk -e night
+#   - p: platform of the unpacked materials (must produce GLSL/ESSL, eg. Android)
+#   - o: write full table (tsv)
+#   - b: baseline table to diff against, exits non-zero on regressions
+#   - t: allowed growth of a frame time in percent (default 10)
+#   - e: only one scene state (day, dusk, night, rain, nether, end, underwater)
+#   - f: only materials whose name contains this
+#   - s: framebuffer size (default 1280x720)
+#   - m: time every state for at least this many ms (default 100)
+# llvmpipe runs single threaded unless LP_NUM_THREADS is set, for steadier numbers
+
+CXX=${CXX:-g++}
+CXXFLAGS="-std=c++17 -O2"
+
+PLATFORM="Android"
+FRAME_ARGS=""
+
+ARG_MODE=""
+for t in "$@"; do
+  if [ "${t:0:1}" == "-" ]; then
+    OPT=${t:1}
+    if [[ "$OPT" =~ ^[pobtefsm]$ ]]; then
+      ARG_MODE=$OPT
+    else
+      echo "Invalid option: $t"
+      exit 1
+    fi
+  elif [ "$ARG_MODE" == "p" ]; then
+    PLATFORM="$t"
+  else
+    FRAME_ARGS+="-$ARG_MODE $t "
+  fi
+  shift
+done
+
+REPORT_DIR="build/$PLATFORM/report"
+OUT_DIR=build/gles
+
+if [ ! -d "$REPORT_DIR" ]; then
+  echo "Error: $REPORT_DIR not found, run report.sh -p $PLATFORM first"
+  exit 1
+fi
+
+echo ">> Compiling $OUT_DIR/frame"
+mkdir -p $OUT_DIR
+$CXX $CXXFLAGS tools/gles/frame.cpp -o $OUT_DIR/frame -lEGL -lGLESv2 || exit 1
+
+echo ">> Frame time ($PLATFORM)"
+LP_NUM_THREADS=${LP_NUM_THREADS:-1} python3 tools/frame_bench.py $REPORT_DIR -r $OUT_DIR/frame $FRAME_ARGS
@@ -35,6 +35,9 @@
  #define NL_EXPOSURE   0.4  // [toggle] 0.5 dark ~ 3.0 bright
 #define NL_SATURATION 0.9 // [toggle] 0.0 grayscale ~ 4.0 super saturated
 //#define NL_TINT vec3(1.0,0.75,0.5) // [toggle] color overlay
+//#define NL_TONEMAP_FIT // [toggle] one fitted curve for exposure, tonemap and contrast (tools/color_fit.py)
+                         // largest error against the exact chain in 8-bit steps: 0.35 default (and subpacks
+                         // sharing its curve), ULTRA 0.38, PVP 0.47, PBR 0.00. Printed again by the tool.
 
 /* Terrain lighting */
 #define NL_SUN_INTENSITY 3.0   // 0.5 weak ~ 5.0 bright
@@ -92,16 +95,29 @@
 #define NL_RAINBOW_CLEAR 0.0 // 0.3 subtle ~ 1.7 bright during clear
 #define NL_RAINBOW_RAIN 1.0  // 0.5 subtle ~ 2.0 bright during rain
 
+/* Falling stars */
+#define NL_FALLING_STARS 0.01       // [toggle] 0.002 rare ~ 0.05 frequent, fraction of sky cells with a star
+#define NL_FALLING_STARS_SPEED 22.0 // 5.0 slow ~ 40.0 fast
+
+/* Cubemap */
+//#define NL_CUBEMAP_TRUST_SKY // [toggle] no sky gradient on the cubemap above the horizon, the sky dome shows through
+
+/* Precision */
+//#define NL_MEDIUMP // [toggle] sky, glow and tonemap at mediump on Android (faster on most phones)
+
 /* Ore glow intensity */
 #define NL_GLOW_TEX 8.0  // 0.4 weak ~ 8.0 bright
 //#define NL_GLOW_SHIMMER  // [toggle] shimmer effect
 #define NL_GLOW_LEAK 1.0 // [toggle] 0.08 subtle ~ 1.0 100% brightness of NL_GLOW_TEX
+//#define NL_GLOW_BAKED    // [toggle] use leak baked into block textures by pack.sh (no extra texture fetches)
+                           // approximation: recovers about a third of the halo, over the pack.sh bound on 54 of 58 textures, keep off
+                           // textures are shared, every subpack must keep it with the same NL_GLOW_LEAK and NL_GLOW_TEX
 
 /* Waving */
 #define NL_PLANTS_WAVE 0.2    // [toggle] 0.02 gentle ~ 0.4 violent
 #define NL_LANTERN_WAVE 0.16   // [toggle] 0.05 subtle ~ 0.4 large swing
 #define NL_WAVE_SPEED 2.8      // 0.5 slow wave ~ 5.0 very fast wave
-//#define NL_EXTRA_PLANTS_WAVE // [toggle] !dont use! wave using texture coords (1.20.40 vanilla)
+//#define NL_EXTRA_PLANTS_WAVE // [toggle] wave plants by texture atlas tile, block_atlas.h must match the game version (tools/block_atlas.py)
 
 /* Water */
 #define NL_WATER_TRANSPARENCY 1.0 // 0.0 transparent ~ 1.0 normal
@@ -138,6 +154,7 @@
 #define NL_CLOUD2_THICKNESS 3.5      // 0.5 slim ~ 5.0 fat
 #define NL_CLOUD2_RAIN_THICKNESS 2.0 // 0.5 slim ~ 5.0 fat
 #define NL_CLOUD2_STEPS 7           // 3 low quality ~ 16 high quality
+//#define NL_CLOUD2_MIN_STEPS 3     // [toggle] 2 fast ~ 16 full steps, fewer steps for distant clouds
 #define NL_CLOUD2_SCALE 0.033         // 0.003 large ~ 0.3 tiny
 #define NL_CLOUD2_SHAPE 0.6         // 0.0 round ~ 1.0 box
 #define NL_CLOUD2_DENSITY 100.0       // 1.0 blurry ~ 100.0 sharp
@@ -156,6 +173,11 @@
 /* Chunk loading slide in animation */
 //#define NL_CHUNK_LOAD_ANIM 100.0 // [toggle] -600.0 fall from top ~ 600.0 rise from bottom
 
+/* Terrain level of detail, as fraction of render distance (on in the MID, SUB and PVP subpacks) */
+//#define NL_LOD_MID 0.3  // [toggle] 0.1 near ~ 1.0 far, no torch flicker, caustic and wave animation beyond
+//#define NL_LOD_FAR 0.6  // [toggle] 0.2 near ~ 1.0 far, no reflection, godray and sky details beyond
+#define NL_LOD_BLEND 0.05 // 0.01 sharp ~ 0.2 smooth transition between tiers
+
 /* Sun/Moon */
 #define NL_SUNMOON_ANGLE -4.0 // [toggle] 0.0 no tilt ~ 90.0 tilt of 90 degrees
 #define NL_SUNMOON_SIZE 1.1     // 0.3 tiny ~ 4.0 massive
@@ -169,6 +191,9 @@
 #define NL_GROUND_RAIN_PUDDLES 0.7 // 0.0 no puddles ~ 1.0 puddles
 #define NL_GROUND_AURORA_REFL    // [toggle] aurora reflection on ground
 #define NL_SHADOWSIDES 0.4
+
+/* Cost heatmap (DEBUG_COST subpack) */
+#define NL_DEBUG_COST_SCALE 1000.0 // cost shown red, twice of it white (units in debug_cost.h)
 /* -------- CONFIG ENDS HERE ----------- */
 
 
@@ -190,25 +215,25 @@
 //#define TONEMAP_H
 
 #ifdef PBR
-#undef NL_TONEMAP_TYPE 4
+#undef NL_TONEMAP_TYPE
 #define NL_TONEMAP_TYPE 6
  #undef NL_SHADOWSIDES 
 #define NL_SHADOWSIDES 0.18
 #undef NL_CLOUD2_STEPS
 #define NL_CLOUD2_STEPS 12
-#undef NL_CLOUD2_SHAPE 0.6
+#undef NL_CLOUD2_SHAPE
 #define NL_CLOUD2_SHAPE 0.32
-#undef NL_GODRAY 1.23
+#undef NL_GODRAY
 #define NL_GODRAY 0.5
 #undef NL_MIST_DENSITY 
 #define NL_MIST_DENSITY 0.7
 #undef NL_VFOG
 #define NL_VFOG 0.7
-#undef NL_CONSTRAST 1.0   // 0.3 low ~ 2.0 high
- #undef NL_EXPOSURE   0.51  // [toggle] 0.5 dark ~ 3.0 bright
-#undef NL_SATURATION 0.75 // [toggle] 0.0 grayscale ~ 
-#undef NL_CONSTRAST 1.3   // 0.3 low ~ 2.0 high
- #undef NL_EXPOSURE   0.9  // [toggle] 0.5 dark ~ 3.0 bright
+#undef NL_CONSTRAST
+ #undef NL_EXPOSURE
+#undef NL_SATURATION
+#undef NL_CONSTRAST
+ #undef NL_EXPOSURE
  // [toggle] 0.0 grayscale ~ 
 #undef NL_EFOG 
 #define NL_EFOG 9.0
@@ -223,7 +248,7 @@
  #endif
 
 #ifdef Full
-#undef NL_CLOUD_TYPE 2// 0:vanilla, 1:soft, 2:rounded ,3: Volumetric
+#undef NL_CLOUD_TYPE
 //#define NL_CLOUD_TYPE 1// 0:vanilla, 1:soft, 2:rounded ,3: Volumetric
 //#define NL_CLOUD1_SCALE vec2(0.016, 0.033) // 0.003 large ~ 0.2 tiny
 //#define NL_CLOUD1_DEPTH 3.0                // 0.0 no bump ~ 10.0 large bumps
@@ -231,22 +256,22 @@
 //#define NL_CLOUD1_DENSITY 0.3             // 0.1 less clouds ~ 0.8 more clouds
 //#define NL_CLOUD1_OPACITY 1.0              // 0.0 invisible ~   #undef NL_CLOUD2_STEPS 
  // #define NL_WATER_CLOUD_REFLECTION
-  #undef NL_TONEMAP_TYPE 4
+  #undef NL_TONEMAP_TYPE
   #define NL_TONEMAP_TYPE 10
-  #undef NL_CONSTRAST 1.5   // 0.3 low ~ 2.0 high
-#undef NL_EXPOSURE   1.0  // [toggle] 0.5 dark ~ 3.0 bright
-#undef NL_SATURATION 1.0 // [toggle] 0.0 grayscale ~ 4.0 
+  #undef NL_CONSTRAST
+#undef NL_EXPOSURE
+#undef NL_SATURATION
 #define NL_CONSTRAST 1.29   // 0.3 low ~ 2.0 high
 #define NL_EXPOSURE   0.59  // [toggle] 0.5 dark ~ 3.0 bright
 #define NL_SATURATION 1.23 // [toggle] 0.0 grayscale ~ 4.0
-#undef NL_MIST_DENSITY 0.69 
+#undef NL_MIST_DENSITY
 #define NL_MIST_DENSITY 0.49
 #undef NL_SHADOWSIDES 
 #define NL_SHADOWSIDES 0.2
 #define NL_MOONLIGHT_INTENSITY 8.0
 #define NL_MOONLIGHT_COLOR vec3(0.059, 0.102, 0.302)
-#undef NL_MOONLIGHT_INTENSITY 10.0
-#undef NL_MOONLIGHT_COLOR vec3(0.059, 0.102, 0.302)
+#undef NL_MOONLIGHT_INTENSITY
+#undef NL_MOONLIGHT_COLOR
     
 #endif
 
@@ -255,18 +280,18 @@
 #endif
 
 #ifdef ULTRA
-#undef NL_TONEMAP_TYPE 4
+#undef NL_TONEMAP_TYPE
 #define NL_TONEMAP_TYPE 9
 
- #undef NL_CONSTRAST 1.0   // 0.3 low ~ 2.0 high
-#undef NL_EXPOSURE   0.4  // [toggle] 0.5 dark ~ 3.0 bright
-#undef NL_SATURATION 1.0 // [toggle] 0.0 grayscale ~ 4.0 
+ #undef NL_CONSTRAST
+#undef NL_EXPOSURE
+#undef NL_SATURATION
 #define NL_CONSTRAST 1.29   // 0.3 low ~ 2.0 high
 #define NL_EXPOSURE   0.42  // [toggle] 0.5 dark ~ 3.0 bright
 #define NL_SATURATION 1.23 // [toggle] 0.0 grayscale ~ 4.0
-#undef NL_MIST_DENSITY 0.5 
+#undef NL_MIST_DENSITY
 #define NL_MIST_DENSITY 0.34
-#undef NL_CLOUD2_STEPS 9
+#undef NL_CLOUD2_STEPS
 #define NL_CLOUD2_STEPS 16
 //#define NL_WATER_CLOUD_REFLECTION
  #undef NL_CLOUD_FLUFFY
@@ -276,12 +301,16 @@
 #endif
 
 #ifdef MID
+  #define NL_LOD_MID 0.3
+  #define NL_LOD_FAR 0.6
   #undef NL_CLOUD2_STEPS 
   #define NL_CLOUD2_STEPS 7
  // #define NL_WATER_CLOUD_REFLECTION
 #endif
 
 #ifdef SUB
+  #define NL_LOD_MID 0.3
+  #define NL_LOD_FAR 0.6
   #undef NL_PLANTS_WAVE
   #undef NL_LANTERN_WAVE
   #undef NL_UNDERWATER_WAVE
@@ -290,6 +319,8 @@
 #endif
 
 #ifdef PVP
+  #define NL_LOD_MID 0.3
+  #define NL_LOD_FAR 0.6
   #undef NL_PLANTS_WAVE
   #undef NL_LANTERN_WAVE
   #undef NL_UNDERWATER_WAVE
@@ -297,18 +328,18 @@
   #undef NL_RAIN_MIST_OPACITY
   #undef NL_FOG_TYPE
   #define NL_FOG_TYPE 0
-  #undef NL_CLOUD2_VELOCIY 0.17
+  #undef NL_CLOUD2_VELOCIY
   #define NL_CLOUD2_VELOCIY 0.02
-  #undef NL_CONSTRAST 1.3   // 0.3 low ~ 2.0 high
-#undef NL_EXPOSURE   0.65  // [toggle] 0.5 dark ~ 3.0 bright
-#undef NL_SATURATION 1.0 // [toggle] 0.0 grayscale ~ 4.0 super saturated
+  #undef NL_CONSTRAST
+#undef NL_EXPOSURE
+#undef NL_SATURATION
 #define NL_CONSTRAST 1.5   // 0.3 low ~ 2.0 high
 #define NL_EXPOSURE   0.6  // [toggle] 0.5 dark ~ 3.0 bright
 #define NL_SATURATION 1.2 // [toggle] 0.0 grayscale ~ 4.0 super saturated
-#undef NL_GLOW_LEAK 0.48
+#undef NL_GLOW_LEAK
 #define NL_GLOW_LEAK 1.0
 #undef NL_WATER_WAVE
-#undef NL_SHADOWSIDES 0.7
+#undef NL_SHADOWSIDES
 #define NL_SHADOWSIDES 0.7
 #endif
  
@@ -317,5 +348,13 @@
 #define NL_WATER_CLOUD_REFLECTION
 #endif
 
+#ifdef MEDIUMP
+  #define NL_MEDIUMP
+#endif
+
+#ifdef DEBUG_COST
+  #define NL_DEBUG_COST
+#endif
+
 /* ------ SUBPACK CONFIG ENDS HERE -------- */
 #endif
\ No newline at end of file
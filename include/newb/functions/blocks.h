@@ -0,0 +1,89 @@
+#ifndef BLOCKS_H
+#define BLOCKS_H
+
+/* Block classes of a RenderChunk vertex as one bitmask, shared by the
+ * lighting (isTree) and the plant and lantern waves. Shapes are told apart
+ * by the exact model positions vanilla blocks use (bPos = fract(a_position)),
+ * plants and leaves by their biome tint. With NL_EXTRA_PLANTS_WAVE the atlas
+ * tile decides which half of a plant waves, from the tables
+ * tools/block_atlas.py generates per Minecraft version (block_atlas.h).
+ * All tests are selects, no branches.
+ */
+
+#define NL_BLOCK_COLORED 1   // biome tinted
+#define NL_BLOCK_TREE    2   // tree leaves (alpha test and seasons only)
+#define NL_BLOCK_PLANT   4   // tinted grass and plants
+#define NL_BLOCK_VINES   8
+#define NL_BLOCK_FARM    16  // crops, 1/16 below the block top
+#define NL_BLOCK_TOP     32  // upper half of the atlas tile
+#define NL_BLOCK_WAVE    64  // plant wave moves this vertex
+#define NL_BLOCK_LANTERN 128
+#define NL_BLOCK_CHAIN   256
+
+#ifdef NL_EXTRA_PLANTS_WAVE
+#include "block_atlas.h"
+
+// 0 default, 1 still, 2 top, 3 bottom. uv0 scaled by (2, 0.5), 32x64 tiles
+int nlAtlasClass(vec2 uv0) {
+  int tile = 32*int(uv0.y*64.0) + int(uv0.x*32.0) - NL_ATLAS_FIRST;
+  int i = clamp(tile, 0, 15*NL_ATLAS_WORDS - 1);
+  int word = i/15;
+  int cls = (NL_ATLAS_TABLE[word] >> (2*(i - 15*word))) & 3;
+  return i == tile ? cls : 0;
+}
+#endif
+
+int nlBlockClass(vec4 COLOR, vec3 bPos, vec2 uv0) {
+  bool isColored = COLOR.r != COLOR.g || COLOR.r != COLOR.b;
+
+#if defined(SEASONS)
+  bool isTree = true;
+#elif defined(ALPHA_TEST)
+  bool isTree = (isColored && (bPos.x+bPos.y+bPos.z < 0.001)) || COLOR.a == 0.0;
+#else
+  bool isTree = false;
+#endif
+
+  int block = (isColored ? NL_BLOCK_COLORED : 0) | (isTree ? NL_BLOCK_TREE : 0);
+
+  // shapes only matter to the waves, which run in the alpha test pass
+#if defined(ALPHA_TEST) && (defined(NL_PLANTS_WAVE) || defined(NL_LANTERN_WAVE))
+  // texture atlas has 32x64 textures (uv0.xy division)
+  uv0 *= vec2(2.0,0.5);
+  float texPosY = fract(uv0.y*64.0);
+
+  // x and z distance from block center
+  vec2 bPosC = abs(bPos.xz-0.5);
+
+  bool isTop = texPosY < 0.5;
+  bool isPlants = isColored && COLOR.r/COLOR.g<1.9;
+  bool isVines = (bPosC.x==0.453125 && bPos.z==0.0) || (bPosC.y==0.453125 && bPos.x==0.0);
+  bool isFarmPlant = (bPos.y==0.9375) && (bPosC.x==0.25 || bPosC.y==0.25);
+  bool shouldWave = ((isTree || isPlants || isVines) && isColored) || (isFarmPlant && isTop);
+
+  #ifdef NL_EXTRA_PLANTS_WAVE
+    int atlas = nlAtlasClass(uv0);
+    shouldWave = atlas == 0 ? shouldWave : atlas == 2 ? isTop : atlas == 3 && !isTop;
+  #endif
+
+  bool y6875 = bPos.y==0.6875;
+  bool y5625 = bPos.y==0.5625;
+  bool isLantern = ( (y6875 || y5625) && bPosC.x==0.125 ) || ( (y5625 || bPos.y==0.125) && (bPosC.x==0.1875) );
+  bool isChain = bPosC.x==0.0625 && y6875;
+
+  // fix for non-hanging lanterns waving top part (works only if texPosY is correct)
+  isLantern = isLantern && !(y5625 && (texPosY < 0.3 || (texPosY>0.55 && texPosY<0.69)));
+
+  block |= (isPlants ? NL_BLOCK_PLANT : 0) | (isVines ? NL_BLOCK_VINES : 0) | (isFarmPlant ? NL_BLOCK_FARM : 0);
+  block |= (isTop ? NL_BLOCK_TOP : 0) | (shouldWave ? NL_BLOCK_WAVE : 0);
+  block |= (isLantern ? NL_BLOCK_LANTERN : 0) | (isChain ? NL_BLOCK_CHAIN : 0);
+#endif
+
+  return block;
+}
+
+bool nlBlockIs(int block, int bit) {
+  return (block & bit) != 0;
+}
+
+#endif
@@ -90,6 +90,17 @@ float snoise(vec2 v) {
 }
 
 float cloudDf(vec3 pos, float rain) {
+  // round y
+  float b = 1.0 - 1.9 * smoothstep(NL_CLOUD2_SHAPE, 2.0 - NL_CLOUD2_SHAPE, 2.0 * abs(pos.y - 0.5));
+
+  // fluffiness adds at most this much to n
+  float maxFluff = 0.5 * NL_CLOUD_FLUFFY;
+
+  // empty near the top and bottom of the layer
+  if ((1.0 + maxFluff) * b <= 0.2) {
+    return 0.0;
+  }
+
   vec2 p0 = floor(pos.xz);
   vec2 u = smoothstep(0.999 * NL_CLOUD2_SHAPE, 1.0, pos.xz - p0);
 
@@ -102,8 +113,10 @@ float cloudDf(vec3 pos, float rain) {
     u.y
   );
 
-  // round y
-  float b = 1.0 - 1.9 * smoothstep(NL_CLOUD2_SHAPE, 2.0 - NL_CLOUD2_SHAPE, 2.0 * abs(pos.y - 0.5));
+  // empty cell, fluffiness can't make it visible
+  if ((n + maxFluff) * b <= 0.2) {
+    return 0.0;
+  }
 
   // Add noise to make the clouds fluffy
   float noiseFactor = NL_CLOUD_FLUFFY;  // Adjust this factor to control the amount of fluffiness
@@ -112,10 +125,21 @@ float cloudDf(vec3 pos, float rain) {
   return smoothstep(0.2, 1.0, (n + fluffiness) * b);
 }
 
-vec4 renderClouds(vec3 vDir, vec3 vPos, float rain, float time, vec3 fogCol, vec3 skyCol) {
+// number of raymarch steps, clouds fading out in the distance get fewer
+int cloudSteps(float fade) {
+#ifdef NL_CLOUD2_MIN_STEPS
+  float quality = 0.5 + 0.5 * fade;
+  return int(clamp(ceil(quality * float(NL_CLOUD2_STEPS)), float(NL_CLOUD2_MIN_STEPS), float(NL_CLOUD2_STEPS)));
+#else
+  return NL_CLOUD2_STEPS;
+#endif
+}
+
+vec4 renderClouds(vec3 vDir, vec3 vPos, float rain, float time, vec3 fogCol, vec3 skyCol, float fade) {
   float height = 7.0 * mix(NL_CLOUD2_THICKNESS, NL_CLOUD2_RAIN_THICKNESS, rain);
+  int steps = cloudSteps(fade);
 
-  // scaled ray offset
+  // scaled ray offset across the slab
   vec3 deltaP;
   deltaP.y = 1.0;
   deltaP.xz = (NL_CLOUD2_SCALE * height) * vDir.xz / (0.02 + 0.98 * abs(vDir.y));
@@ -126,20 +150,34 @@ vec4 renderClouds(vec3 vDir, vec3 vPos, float rain, float time, vec3 fogCol, vec
   vec3 pos;
   pos.y = 0.0;
   pos.xz = NL_CLOUD2_SCALE * (vPos.xz + vec2(1.0, 0.5) * (time * NL_CLOUD2_VELOCIY));
-  pos += deltaP;
 
-  deltaP /= -float(NL_CLOUD2_STEPS);
+  deltaP /= float(steps);
 
-  // alpha, gradient
-  vec2 d = vec2(0.0, 1.0);
-  for (int i = 1; i <= NL_CLOUD2_STEPS; i++) {
-    float m = cloudDf(pos, rain);
+  // march bottom to top, front to back for the gradient
+  // alpha (density sum), gradient, gradient transmittance
+  vec3 d = vec3(0.0, 0.0, 1.0);
 
-    d.x += m;
-    d.y = mix(d.y, pos.y, m);
+  // density sum after which alpha can't go below 0.98
+  float saturated = 49.0 * float(steps) / NL_CLOUD2_DENSITY;
 
+  // constant bound so the loop can be unrolled
+  for (int i = 0; i < NL_CLOUD2_STEPS; i++) {
+    if (i >= steps || (d.z < 0.02 && d.x > saturated)) {
+      break;
+    }
+    NL_ADD_COST(NL_COST_CLOUD_STEP);
     pos += deltaP;
+
+    float m = cloudDf(pos, rain);
+
+    d.x += m;
+    d.y += d.z * m * pos.y;
+    d.z *= 1.0 - m;
   }
+  d.y += d.z;
+
+  // density sum relative to NL_CLOUD2_STEPS samples
+  d.x *= float(NL_CLOUD2_STEPS) / float(steps);
   d.x *= smoothstep(0.03, 0.1, d.x);
   d.x = d.x / ((float(NL_CLOUD2_STEPS) / NL_CLOUD2_DENSITY) + d.x);
 
@@ -156,6 +194,40 @@ vec4 renderClouds(vec3 vDir, vec3 vPos, float rain, float time, vec3 fogCol, vec
   return col;
 }
 
+// rounded clouds seen from below as one flat layer, for reflections
+// cell density of cloudDf in the middle of the layer, without raymarch and fluff
+vec4 renderCloudsRefl(vec2 vPos, float rain, float time, vec3 fogCol, vec3 skyCol) {
+  NL_ADD_COST(NL_COST_CLOUD_REFL);
+  vec2 pos = NL_CLOUD2_SCALE * (vPos + vec2(1.0, 0.5) * (time * NL_CLOUD2_VELOCIY));
+
+  vec2 p0 = floor(pos);
+  vec2 u = smoothstep(0.999 * NL_CLOUD2_SHAPE, 1.0, pos - p0);
+
+  // rain transition
+  vec2 t = vec2(0.1001 + 0.2 * rain, 0.1 + 0.2 * rain * rain);
+
+  float n = mix(
+    mix(randt(p0, t), randt(p0 + vec2(1.0, 0.0), t), u.x),
+    mix(randt(p0 + vec2(0.0, 1.0), t), randt(p0 + vec2(1.0, 1.0), t), u.x),
+    u.y
+  );
+  float m = smoothstep(0.2, 1.0, n);
+
+  // density sum of renderClouds, the rounded top and bottom hold less
+  float d = (0.5 + 0.5 * NL_CLOUD2_SHAPE) * float(NL_CLOUD2_STEPS) * m;
+  d *= smoothstep(0.03, 0.1, d);
+  d = d / ((float(NL_CLOUD2_STEPS) / NL_CLOUD2_DENSITY) + d);
+
+  // dense clouds are darker underneath
+  float shade = 1.0 - 0.45 * m * m;
+
+  vec4 col = vec4(0.6 * skyCol, d);
+  col.rgb += (vec3(0.03, 0.05, 0.05) + 0.8 * fogCol) * shade;
+  col.rgb *= 1.0 - 0.5 * rain;
+
+  return col;
+}
+
 
 // Simplex noise function
 vec4 permute(vec4 x) {
@@ -239,6 +311,7 @@ float noise(vec3 v) {
 
 // Volumetric clouds
 vec4 renderVolumetricClouds(vec3 vDir, vec3 worldPos, vec3 zenithCol, float rain, vec3 fogCol, float time) {
+  NL_ADD_COST(NL_COST_VOLUMETRIC);
   // Parameters for noise and clouds
   float scale = 0.1;
   float density = 0.5;
@@ -263,6 +336,7 @@ vec4 renderVolumetricClouds(vec3 vDir, vec3 worldPos, vec3 zenithCol, float rain
 // aurora is rendered on clouds layer
 #ifdef NL_AURORA
 vec4 renderAurora(vec3 p, float t, float rain, vec3 FOG_COLOR) {
+  NL_ADD_COST(NL_COST_AURORA);
   t *= NL_AURORA_VELOCITY;
   p.xz *= NL_AURORA_SCALE;
   p.xz += 0.05*sin(p.x*4.0 + 20.0*t);
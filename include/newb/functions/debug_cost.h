@@ -0,0 +1,48 @@
+#ifndef DEBUG_COST_H
+#define DEBUG_COST_H
+
+/* Cost heatmap of the DEBUG_COST subpack (NL_DEBUG_COST).
+ * Functions add the cost of the expensive paths they take to nlCost, the
+ * materials write nlCostColor(nlCost) instead of their color. RenderChunk
+ * passes its vertex cost to the fragment stage (v_cost), so a pixel shows
+ * the vertex cost around it plus its own.
+ *
+ * Costs are ns/call of the CPU bench (./bench.sh, default config), rounded.
+ * Only relative values matter. Texture fetches have no CPU number and are
+ * counted as 10.
+ */
+
+#define NL_COST_TAP         10.0  // texture fetch (glow leak)
+#define NL_COST_SKY         50.0  // nlRenderSky, overworld gradient and sun bloom
+#define NL_COST_SKY_FAR     10.0  // nlRenderSkyFar, gradient or mean End sky
+#define NL_COST_END_SKY     150.0 // renderEndSky
+#define NL_COST_STARS       15.0  // nlFallingStars
+#define NL_COST_CLOUD_STEP  75.0  // one raymarch step of renderClouds (cloudDf)
+#define NL_COST_CLOUD_REFL  50.0  // renderCloudsRefl
+#define NL_COST_VOLUMETRIC  250.0 // renderVolumetricClouds
+#define NL_COST_AURORA      105.0 // renderAurora
+#define NL_COST_WATER       125.0 // nlWater on a water surface
+#define NL_COST_REFL        40.0  // nlRefl wet ground reflection
+#define NL_COST_GODRAY      35.0  // nlRenderGodRayIntensity at dawn/dusk
+#define NL_COST_WAVE        80.0  // nlWave, plants and lanterns
+
+#ifdef NL_DEBUG_COST
+  #if BGFX_SHADER_LANGUAGE_GLSL || BGFX_SHADER_LANGUAGE_SPIRV || BGFX_SHADER_LANGUAGE_METAL
+    float nlCost = 0.0;
+  #else
+    // HLSL makes a non-static global a uniform
+    static float nlCost = 0.0;
+  #endif
+  #define NL_ADD_COST(C) nlCost += C
+#else
+  #define NL_ADD_COST(C)
+#endif
+
+// blue, cyan, green, yellow, red from 0 to NL_DEBUG_COST_SCALE, to white at twice of it
+vec3 nlCostColor(float cost) {
+  float x = 4.0*cost/NL_DEBUG_COST_SCALE;
+  vec3 col = clamp(min(vec3(x - 1.5, x - 0.5, x + 0.5), vec3(5.5 - x, 3.5 - x, 2.5 - x)), 0.0, 1.0);
+  return mix(col, vec3(1.0, 1.0, 1.0), clamp(0.25*x - 1.0, 0.0, 1.0));
+}
+
+#endif
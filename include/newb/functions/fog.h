@@ -39,44 +39,47 @@ float nlRenderFogFade(float relativeDist, vec3 FOG_COLOR, vec2 FOG_CONTROL) {
 }
 
 float nlRenderGodRayIntensity(vec3 cPos, vec3 worldPos, float t, vec2 uv1, float relativeDist, vec3 FOG_COLOR) {
+    // Dawn/dusk mask, same for the whole draw
+    float fogIntensity = clamp(3.0 * (FOG_COLOR.r - FOG_COLOR.b), 0.0, 1.0);
+    if (fogIntensity <= 0.0) {
+        return 0.0;
+    }
+    NL_ADD_COST(NL_COST_GODRAY);
+
     // Offset world position (only works up to 16 blocks)
     vec3 offset = cPos - 16.0 * fract(worldPos * 0.0625);
     offset = abs(2.0 * fract(offset * 0.0625) - 1.0);
     offset = offset * offset * (3.0 - 2.0 * offset); // Smoothstep interpolation
 
-    vec3 nrmof = normalize(worldPos);
-
-    float u = nrmof.z / length(nrmof.zy);
+    // u = n.z/length(n.zy) and mask = n.x^2 for n = normalize(worldPos)
+    float u = worldPos.z * inversesqrt(dot(worldPos.zy, worldPos.zy));
     float diff = dot(offset, vec3(0.1, 0.2, 1.0)) + 0.07 * t;
-    float mask = nrmof.x * nrmof.x;
+    float mask = worldPos.x * worldPos.x / dot(worldPos, worldPos);
 
     // Create a smoother volumetric function using sin and cos
     float vol = sin(7.0 * u + 1.5 * diff) * sin(3.0 * u + diff);
     vol = vol * vol * mask * uv1.y * (1.0 - mask * mask);
     vol = vol * relativeDist * relativeDist;
 
-    // Dawn/dusk mask
-    float fogIntensity = clamp(3.0 * (FOG_COLOR.r - FOG_COLOR.b), 0.0, 1.0);
     vol *= fogIntensity;
 
     // Apply a smoother step function to the volumetric intensity
     vol = smoothstep(0.0, 0.1, vol);
     vol = smoothstep(0.0, 1.0, vol); // Additional smoothing step
 
-    // Enhance the godrays effect by adding a light scattering term
-    float scatter = exp(-relativeDist * 0.1) * (1.0 - exp(-relativeDist * 0.1));
-    vol *= scatter;
-
-    // Further smooth the volumetric effect with another smoothstep
-    vol = smoothstep(0.0, 0.5, vol);
-    vol = smoothstep(0.0, 1.0, vol);
-
-    // Amplify the volumetric godrays for more dramatic effect
-    vol = pow(vol, NL_VFOG); // Adjust this exponent to control intensity
+    // Light scattering term, e*(1-e) with e = exp(-0.1*relativeDist)
+    float e = exp(-0.1 * relativeDist);
+    vol *= e - e * e;
 
-    // Add a final touch of realistic light scattering
-    vol *= exp(-relativeDist * 0.8); // Adjust this factor for desired scattering effect
+    // pow(smoothstep(0.0, 1.0, smoothstep(0.0, 0.5, vol)), NL_VFOG) as one curve,
+    // fitted for vol <= 0.25 (the scattering term can't go higher)
+    // error below 0.003 for NL_VFOG up to 0.7, checked by ./bench.sh -t godray
+    float vol2 = vol * vol;
+    vol = pow(432.0 * vol2 * vol2 * (1.0 - 3.35 * vol + 2.12 * vol2), NL_VFOG);
 
-    return vol;
+    // Final light scattering, exp(-0.8*relativeDist) = e^8
+    e *= e;
+    e *= e;
+    return vol * e * e;
 }
 #endif
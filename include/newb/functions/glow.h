@@ -17,20 +17,23 @@ vec3 glowDetect(vec4 diffuse) {
   return vec3(0.0,0.0,0.0);
 }
 
-vec3 glowDetectC(sampler2D tex, vec2 uv) {
+vec3 glowDetectC(sampler2D tex, highp vec2 uv) {
   return glowDetect(texture2DLod(tex, uv, 0.0));
 }
 
-vec3 nlGlow(sampler2D tex, vec2 uv, vec4 diffuse, float shimmer) {
+// uv is highp, mediump can not address single atlas texels
+vec3 nlGlow(sampler2D tex, highp vec2 uv, vec4 diffuse, float shimmer) {
   vec3 glow = glowDetect(diffuse);
 
-  #ifdef NL_GLOW_LEAK
+  // NL_GLOW_BAKED: leak is baked into the textures by tools/glow_bake.py
+  #if defined(NL_GLOW_LEAK) && !defined(NL_GLOW_BAKED)
   // glow leak is done by interpolating 8 surrounding pixels
   // c3 c4 c5
   // c2    c6
   // c1 c8 c7
-  const vec2 texSize = vec2(2048.0, 1024.0);
-  const vec2 offset = 1.0 / texSize;
+  const highp vec2 texSize = vec2(2048.0, 1024.0);
+  const highp vec2 offset = 1.0 / texSize;
+  NL_ADD_COST(8.0*NL_COST_TAP);
 
   vec3 c1 = glowDetectC(tex, uv - offset);
   vec3 c2 = glowDetectC(tex, uv + offset*vec2(-1, 0));
@@ -41,7 +44,7 @@ vec3 nlGlow(sampler2D tex, vec2 uv, vec4 diffuse, float shimmer) {
   vec3 c7 = glowDetectC(tex, uv + offset*vec2( 1,-1));
   vec3 c8 = glowDetectC(tex, uv + offset*vec2( 0,-1));
 
-  vec2 p = uv * texSize;
+  highp vec2 p = uv * texSize;
   vec2 u = fract(p);
   //u *= u*(3.0 - 2.0*u);
   vec2 v = 1.0 - u;
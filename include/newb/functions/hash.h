@@ -0,0 +1,23 @@
+#ifndef HASH_H
+#define HASH_H
+
+/* Hashes without sin, only fract/mul/add.
+ * Based on "Hash without Sine" by Dave Hoskins (MIT), with a fract after
+ * every step so fp16 keeps the fraction on the 1/16 lattice of tiledCpos.
+ * Constants are tuned with tools/cpu/hash.cpp (./bench.sh -t hash).
+ * hashNN: N outputs from N inputs, values in [0,1)
+ */
+
+highp float hash12(highp vec2 p) {
+  highp vec3 p3 = fract(p.xyx * vec3(0.3900, 0.4185, 0.5745));
+  p3 = fract(p3 + dot(p3, p3.yzx + 4.05));
+  return fract(6.0 * (p3.x * p3.y + p3.z));
+}
+
+// integer inputs, split in two small parts: past 2^12 a single p*k keeps too little fraction
+highp float hash11(highp float p) {
+  highp float hi = floor(p * (1.0 / 256.0));
+  return hash12(vec2(p - hi * 256.0, hi));
+}
+
+#endif
@@ -70,7 +70,7 @@ vec3 sunLightTint(float dayFactor, float rain, vec3 FOG_COLOR) {
 
 vec3 nlLighting(
     vec3 wPos, out vec3 torchColor, vec3 COLOR, vec3 FOG_COLOR, float rainFactor, vec2 uv1, vec2 lit, bool isTree,
-    vec3 horizonCol, vec3 zenithCol, float shade, bool end, bool nether, bool underwater, highp float t
+    vec3 horizonCol, vec3 zenithCol, float shade, bool end, bool nether, bool underwater, highp float t, float lodMid
 ) {
     vec3 light;
 
@@ -89,8 +89,10 @@ vec3 nlLighting(
     float torchAttenuation = (NL_TORCH_INTENSITY * uv1.x) / (0.5 - 0.45 * lit.x);
 
 #ifdef NL_BLINKING_TORCH
-    // Add blinking effect to torch light intensity
-    torchAttenuation *= 1.0 - 0.12 * noise1D(t * 9.0);
+    // Add blinking effect to torch light intensity (faded out in mid tier)
+    if (lodMid < 1.0) {
+        torchAttenuation *= 1.0 - 0.12 * (1.0 - lodMid) * noise1D(t * 9.0);
+    }
 #endif
 
     // Calculate torch light contribution
@@ -165,16 +167,22 @@ vec3 nlPBRLighting(vec3 N, vec3 V, vec3 L, vec3 lightColor, vec3 albedo, float m
     return Lo;
 }
 
-void nlUnderwaterLighting(inout vec3 light, inout vec3 pos, vec2 lit, vec2 uv1, vec3 tiledCpos, vec3 cPos, highp float t, vec3 horizonCol) {
-    // soft caustic effect
+void nlUnderwaterLighting(inout vec3 light, inout vec3 pos, vec2 lit, vec2 uv1, vec3 tiledCpos, vec3 cPos, highp float t, vec3 horizonCol, float lodMid) {
+    // soft caustic effect, mid tier uses its time average
     if (uv1.y < 0.9) {
-        float caustics = disp(tiledCpos*vec3(1.0,0.1,1.0), t);
-        caustics += (1.0 + sin(t + (cPos.x+cPos.z)*NL_CONST_PI_HALF));
+        float caustics = 1.5;
+        if (lodMid < 1.0) {
+            float anim = disp(tiledCpos*vec3(1.0,0.1,1.0), t);
+            anim += (1.0 + sin(t + (cPos.x+cPos.z)*NL_CONST_PI_HALF));
+            caustics = mix(anim, caustics, lodMid);
+        }
         light += NL_UNDERWATER_BRIGHTNESS + NL_CAUSTIC_INTENSITY*caustics*(0.1 + lit.y + lit.x*0.7);
     }
     light *= mix(normalize(horizonCol), vec3(1.0,1.0,1.0), lit.y*0.6);
 #ifdef NL_UNDERWATER_WAVE
-    pos.xy += NL_UNDERWATER_WAVE*min(0.05*pos.z,0.6)*sin(t*1.2 + dot(cPos,vec3_splat(NL_CONST_PI_HALF)));
+    if (lodMid < 1.0) {
+        pos.xy += (1.0-lodMid)*NL_UNDERWATER_WAVE*min(0.05*pos.z,0.6)*sin(t*1.2 + dot(cPos,vec3_splat(NL_CONST_PI_HALF)));
+    }
 #endif
 }
 
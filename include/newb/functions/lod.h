@@ -0,0 +1,22 @@
+#ifndef LOD_H
+#define LOD_H
+
+/* Distance tiers for terrain vertices (near, mid, far)
+ * relativeDist: camera distance / render distance
+ * returns x: mid tier weight, y: far tier weight
+ * a weight rises 0 -> 1 over NL_LOD_BLEND before its tier starts,
+ * effects dropped by a tier are faded with it, so tiers meet without seams
+ */
+vec2 nlLod(float relativeDist) {
+  vec2 lod = vec2(0.0,0.0);
+#ifdef NL_LOD_FAR
+  lod.y = smoothstep(NL_LOD_FAR - NL_LOD_BLEND, NL_LOD_FAR, relativeDist);
+  lod.x = lod.y;
+#endif
+#ifdef NL_LOD_MID
+  lod.x = max(lod.x, smoothstep(NL_LOD_MID - NL_LOD_BLEND, NL_LOD_MID, relativeDist));
+#endif
+  return lod;
+}
+
+#endif
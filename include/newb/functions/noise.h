@@ -2,15 +2,11 @@
 #define NOISE_H
 
 #include "constants.h"
+#include "hash.h"
 
-// hash function for noise (for highp only)
-highp float rand(highp vec2 n) {
-  return fract(sin(dot(n, vec2(12.9898, 4.1414))) * 43758.5453);
-}
-
-// rand with transition
+// lattice hash with transition
 float randt(vec2 n, vec2 t) {
-  return smoothstep(t.x, t.y, rand(n));
+  return smoothstep(t.x, t.y, hash12(n));
 }
 
 // 1D noise - used in plants,lantern wave
@@ -18,18 +14,13 @@ highp float noise1D(highp float x) {
   float x0 = floor(x);
   float t0 = x-x0;
   t0 *= t0*(3.0-2.0*t0);
-  return mix(fract(sin(x0)*84.85), fract(sin(x0+1.0)*84.85), t0);
-}
-
-// simpler rand for disp, puddles
-float fastRand(vec2 n){
-  return fract(37.45*sin(dot(n, vec2(4.36, 8.28))));
+  return mix(hash11(x0), hash11(x0+1.0), t0);
 }
 
 // water displacement map (also used by caustic)
 float disp(vec3 pos, highp float t) {
   float val = 0.5 + 0.5*sin(t*1.7 + (pos.x+pos.y)*NL_CONST_PI_HALF);
-  return mix(fastRand(pos.xz), fastRand(pos.xz+vec2_splat(1.0)), val);
+  return mix(hash12(pos.xz), hash12(pos.xz+vec2_splat(1.0)), val);
 }
 
 #endif
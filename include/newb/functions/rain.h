@@ -21,8 +21,21 @@ float nlWindblow(vec2 p, float t){
   return 0.25 * val * val;
 }
 
+// ground reflection strength of a vertex from its face shade (shade of
+// RenderChunk.vertex.sc, tint removed): 0.4 at 0.82 or less ~ 1.0 at 0.88.
+// Without normals the shade cannot tell an AO darkened top face from a side
+// face, so the fragment shader keeps reflection to horizontal faces (nlFlatFace).
+float nlReflShade(float shade) {
+  return clamp(shade*10.0, 8.2, 8.8) - 7.8;
+}
+
+// true where world y does not change across the pixel, dy = dFdy(world y)
+bool nlFlatFace(float dy) {
+  return abs(dy) < 0.0002;
+}
+
 vec4 nlRefl(
-  inout vec4 color, inout vec4 mistColor, vec2 lit, vec2 uv1, vec3 tiledCpos,
+  inout vec4 color, inout vec4 mistColor, vec2 lit, vec2 uv1, vec3 tiledCpos, float reflShade,
   float camDist, vec3 wPos, vec3 viewDir, vec3 torchColor, vec3 horizonEdgeCol, vec3 horizonCol,
   vec3 zenithCol, vec3 FOG_COLOR, float rainFactor, float renderDist, highp float t, vec3 pos, bool underWater, bool end, bool nether
 ) {
@@ -39,11 +52,19 @@ vec4 nlRefl(
       mistColor.a = min(mistColor.a + humidAir * NL_RAIN_MIST_OPACITY, 1.0);
     #endif
 
-    // clip reflection when far (better performance)
+    // clip reflection in far tier (better performance)
+    #ifdef NL_LOD_FAR
+    float endDist = renderDist * NL_LOD_FAR;
+    #else
     float endDist = renderDist * 0.6;
+    #endif
     if (camDist < endDist) {
       float cosR = max(viewDir.y, 0.0);
-      float puddles = max(1.0 - NL_GROUND_RAIN_PUDDLES * fastRand(tiledCpos.xz), 0.0);
+      float puddles = 1.0;
+      if (rainFactor > 0.0) {
+        // puddles only show when raining
+        puddles = max(1.0 - NL_GROUND_RAIN_PUDDLES * hash12(tiledCpos.xz), 0.0);
+      }
 
       #ifndef NL_GROUND_REFL
       wetness *= puddles;
@@ -59,8 +80,9 @@ vec4 nlRefl(
       #endif
 
       if (wPos.y < 0.0) {
+        NL_ADD_COST(NL_COST_REFL);
         wetRefl.rgb = getSkyRefl(horizonEdgeCol, horizonCol, zenithCol, viewDir, FOG_COLOR, t, -wPos.y, rainFactor, end, underWater, nether);
-        wetRefl.a = calculateFresnel(cosR, 0.03) * reflective;
+        wetRefl.a = calculateFresnel(cosR, 0.03) * reflective * reflShade;
 
         #if defined(NL_GROUND_AURORA_REFL) && defined(NL_AURORA) && defined(NL_GROUND_REFL)
         vec2 parallax = viewDir.xz / viewDir.y;
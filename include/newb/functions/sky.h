@@ -92,6 +92,7 @@ vec3 getSunBloom(float viewDirX, vec3 horizonEdgeCol, vec3 FOG_COLOR) {
 
 
 vec3 renderEndSky(vec3 horizonCol, vec3 zenithCol, vec3 viewDir, float t) {
+  NL_ADD_COST(NL_COST_END_SKY);
   t *= 0.78; // Accelerate time effect
 
   float a = atan2(viewDir.x, viewDir.z);
@@ -118,6 +119,42 @@ vec3 renderEndSky(vec3 horizonCol, vec3 zenithCol, vec3 viewDir, float t) {
   return sky;
 }
 
+// renderEndSky with its waves at their time average, no trigonometry
+vec3 renderEndSkyFar(vec3 horizonCol, vec3 zenithCol, vec3 viewDir) {
+  const float waves = 0.54; // fitted to the mean of renderEndSky over time
+
+  float grad = 0.5 + 0.5*viewDir.y;
+  float streaks = waves*(1.0 - grad*grad*grad);
+  streaks += (1.0 - streaks) * smoothstep(1.0 - waves, -1.0, viewDir.y);
+
+  float f = 0.5*streaks + 0.5*smoothstep(1.0, -0.5, viewDir.y);
+  float h = streaks*streaks;
+  float g = h*h;
+  g *= g;
+
+  vec3 sky = mix(zenithCol, horizonCol, f*f);
+  sky += (0.3*streaks + 2.0*g*g*g + h*h*h) * vec3(2.0, 0.5, 0.0);
+  sky += 0.5*streaks * vec3(0.31, 0.25, 0.31); // mean of spectrum(sin(x))
+
+  return sky;
+}
+
+#ifdef NL_UNDERWATER_STREAKS
+// light streaks seen from under water
+vec3 renderUnderwaterStreaks(vec3 horizonCol, vec3 viewDir, float t) {
+  float a = atan2(viewDir.x, viewDir.z);
+  float grad = 0.5 + 0.5*viewDir.y;
+  grad *= grad;
+  float spread = (0.5 + 0.5*sin(3.0*a + 0.2*t + 2.0*sin(5.0*a - 0.4*t)));
+  spread *= (0.5 + 0.5*sin(3.0*a - sin(0.5*t)))*grad;
+  spread += (1.0-spread)*grad;
+  float streaks = spread*spread;
+  streaks *= streaks;
+  streaks = (spread + 3.0*grad*grad + 4.0*streaks*streaks);
+  return 2.0*streaks*horizonCol;
+}
+#endif
+
 vec3 nlRenderSky(vec3 horizonEdgeCol, vec3 horizonCol, vec3 zenithCol, vec3 viewDir, vec3 FOG_COLOR, float t, float rainFactor, bool end, bool underWater, bool nether) {
   vec3 sky;
   viewDir.y = -viewDir.y;
@@ -125,22 +162,18 @@ vec3 nlRenderSky(vec3 horizonEdgeCol, vec3 horizonCol, vec3 zenithCol, vec3 view
   if (end) {
     sky = renderEndSky(horizonCol, zenithCol, viewDir, t);
   } else {
-    sky = renderOverworldSky(horizonEdgeCol, horizonCol, zenithCol, viewDir);
+    NL_ADD_COST(NL_COST_SKY);
+    // underwater sky colors are all the same, no gradient needed
+    sky = underWater ? horizonCol : renderOverworldSky(horizonEdgeCol, horizonCol, zenithCol, viewDir);
     #ifdef NL_RAINBOW
-      sky += mix(NL_RAINBOW_CLEAR, NL_RAINBOW_RAIN, rainFactor)*spectrum((viewDir.z+0.6)*8.0)*max(viewDir.y, 0.0)*FOG_COLOR.g;
+      float rainbow = mix(NL_RAINBOW_CLEAR, NL_RAINBOW_RAIN, rainFactor)*FOG_COLOR.g;
+      if (rainbow > 0.0) {
+        sky += rainbow*spectrum((viewDir.z+0.6)*8.0)*max(viewDir.y, 0.0);
+      }
     #endif
     #ifdef NL_UNDERWATER_STREAKS
       if (underWater) {
-        float a = atan2(viewDir.x, viewDir.z);
-        float grad = 0.5 + 0.5*viewDir.y;
-        grad *= grad;
-        float spread = (0.5 + 0.5*sin(3.0*a + 0.2*t + 2.0*sin(5.0*a - 0.4*t)));
-        spread *= (0.5 + 0.5*sin(3.0*a - sin(0.5*t)))*grad;
-        spread += (1.0-spread)*grad;
-        float streaks = spread*spread;
-        streaks *= streaks;
-        streaks = (spread + 3.0*grad*grad + 4.0*streaks*streaks);
-        sky += 2.0*streaks*horizonCol;
+        sky += renderUnderwaterStreaks(horizonCol, viewDir, t);
       } else 
     #endif
     if (!nether) {
@@ -151,6 +184,24 @@ vec3 nlRenderSky(vec3 horizonEdgeCol, vec3 horizonCol, vec3 zenithCol, vec3 view
   return sky;
 }
 
+// sky for fog of far terrain (see nlLod): gradient without sun bloom and rainbow,
+// the End waves at their mean, underwater streaks kept
+vec3 nlRenderSkyFar(vec3 horizonEdgeCol, vec3 horizonCol, vec3 zenithCol, vec3 viewDir, float t, bool end, bool underWater) {
+  NL_ADD_COST(NL_COST_SKY_FAR);
+  viewDir.y = -viewDir.y;
+  if (end) {
+    return renderEndSkyFar(horizonCol, zenithCol, viewDir);
+  }
+  if (underWater) {
+    vec3 sky = horizonCol;
+    #ifdef NL_UNDERWATER_STREAKS
+      sky += renderUnderwaterStreaks(horizonCol, viewDir, t);
+    #endif
+    return sky;
+  }
+  return renderOverworldSky(horizonEdgeCol, horizonCol, zenithCol, viewDir);
+}
+
 // sky reflection on plane
 vec3 getSkyRefl(vec3 horizonEdgeCol, vec3 horizonCol, vec3 zenithCol, vec3 viewDir, vec3 FOG_COLOR, float t, float h, float rainFactor, bool end, bool underWater, bool nether) {
   viewDir.y = -viewDir.y;
@@ -0,0 +1,40 @@
+#ifndef STARS_H
+#define STARS_H
+
+#include "hash.h"
+
+/* Falling stars, after "Falling Stars" by i11212: https://www.shadertoy.com/view/mdVXDm
+ * The sky is split into cells 1 wide and 10 tall that scroll down over time.
+ * One hash per cell picks the NL_FALLING_STARS fraction of cells that hold a
+ * star trail. The head dot of a star reaches into the top of the cell below
+ * it, only there a second hash is needed; all other cells return right
+ * after the first.
+ */
+
+// uv: sky position in cell widths
+vec3 nlFallingStars(highp vec2 uv, highp float t) {
+  NL_ADD_COST(NL_COST_STARS);
+  highp vec2 p = vec2(uv.x, 0.1*(NL_FALLING_STARS_SPEED*t - 0.8776*uv.y));
+  highp vec2 cell = floor(p);
+  vec2 f = p - cell;
+  float v;
+  if (hash12(cell) < NL_FALLING_STARS) {
+    // trail, brightest at the head (bottom of the cell)
+    v = clamp(1.0 - abs(f.x - 0.5) - 0.5*f.y, 0.0, 1.0);
+  } else if (f.y >= 0.95 && hash12(cell + vec2(0.0, 1.0)) < NL_FALLING_STARS) {
+    // head dot of the star in the cell above, round in unscaled sky units
+    vec2 d = fract(vec2(p.x, 10.0*p.y) - vec2(0.0, 0.5)) - 0.5;
+    v = clamp(0.9 - length(d), 0.0, 1.0);
+  } else {
+    return vec3(0.0, 0.0, 0.0);
+  }
+
+  // pow(v, vec3(16,7,5)) with multiplies: red core, blue glow
+  float v2 = v*v;
+  float v4 = v2*v2;
+  float v5 = v4*v;
+  float v8 = v4*v4;
+  return vec3(v8*v8, v5*v2, v5);
+}
+
+#endif
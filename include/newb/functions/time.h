@@ -0,0 +1,20 @@
+#ifndef TIME_H
+#define TIME_H
+
+/* Game time wrapped for mediump.
+ * ViewPositionAndTime.w keeps growing for the whole session, mediump (fp16)
+ * only has 1/8 s steps past 1024 s. Wrapping at a period that holds a whole
+ * number of cycles of every sin(k*t) fed with it keeps those animations
+ * seamless. Wrap in highp, the result fits mediump.
+ */
+
+// 20*pi: sky streaks (k = 0.2, 0.4, 0.5)
+#define NL_TIME_PERIOD_SKY 62.831853
+// 2*pi/0.39: end sky (k = 0.39, 0.78, 1.56, 3.12)
+#define NL_TIME_PERIOD_END 16.110731
+
+highp float nlWrapTime(highp float t, highp float period) {
+  return t - period*floor(t/period);
+}
+
+#endif
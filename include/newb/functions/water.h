@@ -13,32 +13,34 @@ float calculateFresnel(float cosR, float r0) {
     return r0 + (1.0-r0)*a2*a2*a;
 }
 
-vec3 wReflection(vec3 viewDir, vec3 wPos, float rainFactor, float t, vec4 FOG_COLOR, vec3 zenithCol, vec3 horizonCol, vec3 horizonEdgeCol) {
-
-    vec3 wRefl;
+// clouds and aurora of the sky mirrored on water, composited over the sky reflection
+// like the Clouds material does, with a single layer for the rounded clouds
+vec3 wReflection(vec3 refl, vec3 viewDir, vec3 wPos, float rainFactor, highp float t, vec3 FOG_COLOR, vec3 zenithCol, vec3 horizonCol, vec3 horizonEdgeCol) {
 #if defined(NL_WATER_CLOUD_REFLECTION)
     if (wPos.y < 0.0) {
-        vec2 pa = viewDir.xz/viewDir.y;
-        //vec3 reflPos = vec3(wPos.x, -wPos.y, wPos.z)*vec3(2.0,1.0,2.0);
-        vec2 reflPos = wPos.xz - pa*80.0*(1.0-0.0);
+        // where the mirrored view ray meets the cloud layer, 80 blocks above the camera
+        vec2 reflPos = wPos.xz - (80.0 - wPos.y)*viewDir.xz/viewDir.y;
         float fade = clamp(2.0 - 0.004*length(reflPos), 0.0, 1.0);
 
-#ifdef NL_AURORA
-        vec4 aurora = renderAurora(reflPos.xyy, t, rainFactor, FOG_COLOR.rgb);
-        wRefl += 4.0*aurora.rgb*aurora.a*fade;
-#endif
-//adjust 0.5 to ur preference
+        if (fade > 0.0) {
 #if NL_CLOUD_TYPE == 2
-        vec4 clouds = renderClouds(viewDir, reflPos.xyy, rainFactor, t,zenithCol, FOG_COLOR.rgb );
-        wRefl = mix(wRefl, 0.5*clouds.rgb, clouds.a*fade);
+            vec4 clouds = renderCloudsRefl(reflPos, rainFactor, t, horizonEdgeCol, zenithCol);
 #elif NL_CLOUD_TYPE == 1
-        vec4 clouds = renderCloudsSimple(reflPos.xyy, t, rainFactor, zenithCol, horizonCol, horizonEdgeCol);
-        wRefl = mix(wRefl, NL_WATER_CLOUD_REFL*clouds.rgb, clouds.a*fade);
+            vec4 clouds = renderCloudsSimple(reflPos.xyy, t, rainFactor, zenithCol, horizonCol, horizonEdgeCol);
+#else
+            vec4 clouds = vec4(0.0, 0.0, 0.0, 0.0);
+#endif
+
+#ifdef NL_AURORA
+            clouds += renderAurora(reflPos.xyy, t, rainFactor, FOG_COLOR)*(1.0 - 0.95*clouds.a);
 #endif
+
+            refl = mix(refl, clouds.rgb, clouds.a*fade);
+        }
     }
 #endif
 
-    return wRefl;
+    return refl;
 }
 
 vec4 nlWater(
@@ -53,6 +55,7 @@ vec4 nlWater(
 
     // Apply water surface effects only if fractCposY > 0.0 (top plane)
     if (fractCposY > 0.0) {
+        NL_ADD_COST(NL_COST_WATER);
         // Modify bump based on procedural noise
         bump *= disp(tiledCpos, t) + 0.12 * sin(t * 2.0 + dot(cPos, vec3_splat(NL_CONST_PI_HALF)));
 
@@ -63,6 +66,9 @@ vec4 nlWater(
 
         // Sky reflection
         waterRefl = getSkyRefl(horizonEdgeCol, horizonCol, zenithCol, viewDir, FOG_COLOR, t, -wPos.y, rainFactor, end, underWater, nether);
+        if (!(end || nether || underWater)) {
+            waterRefl = wReflection(waterRefl, viewDir, wPos, rainFactor, t, FOG_COLOR, zenithCol, horizonCol, horizonEdgeCol);
+        }
 
         // Add moonlight reflection effect (fake)
         float moonlightFactor = clamp(dot(viewDir, normalize(vec3(0.5, 0.5, 0.5))), 0.0, 1.0);
@@ -8,16 +8,41 @@
 // Global configuration
 #include "config.h"
 
-// Newb legacy functions
+// NL_DEBUG_COST: cost counters, before all functions that add to them
+#include "functions/debug_cost.h"
+
+// NL_MEDIUMP: per pixel sky, glow and tonemap math at mediump on Android (ESSL)
+#if defined(NL_MEDIUMP) && BX_PLATFORM_ANDROID && BGFX_SHADER_TYPE_FRAGMENT
+  #define NL_FP16
+#endif
+
+// Hashes and noise need highp, keep them out of the mediump block
+#include "functions/noise.h"
+#include "functions/time.h"
+
+#ifdef NL_FP16
+precision mediump float;
+#endif
+
+// Fragment stage functions, fp16 safe (compare with ./bench.sh -t precision)
 #include "functions/tonemap.h"
+#include "functions/sky.h"
+#include "functions/stars.h"
+#include "functions/glow.h"
+
+// back to the default of bgfx, so uniforms of the material keep matching the vertex stage
+#ifdef NL_FP16
+precision highp float;
+#endif
+
+// Newb legacy functions
 #include "functions/detection.h"
 #include "functions/fog.h"
-#include "functions/sky.h"
 #include "functions/clouds.h"
 #include "functions/lighting.h"
 #include "functions/water.h"
 #include "functions/rain.h"
 #include "functions/wave.h"
-#include "functions/glow.h"
+#include "functions/lod.h"
 
 #endif
@@ -16,6 +16,8 @@ SUBPACK_OPTIONS=(
   SUB
   PVP
   RREFLECTION
+  MEDIUMP
+  DEBUG_COST
   DEFAULT
 )
 SUBPACK_NAMES=(
@@ -27,6 +29,8 @@ SUBPACK_NAMES=(
   "Sub"
    "pvp"
    "Rreflection"
+  "mediump"
+  "debug cost"
   "Default"
 )
 SUBPACK_MATERIALS=(
@@ -38,6 +42,10 @@ SUBPACK_MATERIALS=(
   "RenderChunk"
    "RenderChunk"
   "Clouds ; RenderChunk ; Sky ; EndSky"
+  "Clouds ; RenderChunk ; Sky ; LegacyCubemap"
+  "Clouds ; RenderChunk ; Sky ; EndSky ; LegacyCubemap"
   ""
 )
 
+# Development subpacks, left out of the pack unless pack.sh -d
+DEV_SUBPACKS="DEBUG_COST"
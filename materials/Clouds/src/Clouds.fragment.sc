@@ -13,14 +13,17 @@ void main() {
 #if defined(TRANSPARENT) && NL_CLOUD_TYPE == 2
   vec3 vDir = normalize(v_color0.xyz);
 
-  color = renderClouds(vDir, v_color0.xyz, v_color1.a, v_color2.a, v_color2.rgb, v_color1.rgb);
+  color = renderClouds(vDir, v_color0.xyz, v_color1.a, v_color2.a, v_color2.rgb, v_color1.rgb, v_color0.a);
 
   #ifdef NL_CLOUD2_MULTILAYER
-    vec2 parallax = vDir.xz / abs(vDir.y) * 143.0;
-    vec3 offsetPos = v_color0.xyz;
-    offsetPos.xz += parallax;
-    vec4 color2 = renderClouds(vDir, offsetPos, v_color1.a, v_color2.a*2.0, v_color2.rgb, v_color1.rgb);
-    color = mix(color2, color, 0.2 + 0.8*color.a);
+    // upper layer is hidden by an opaque lower layer
+    if (color.a < 0.99) {
+      vec2 parallax = vDir.xz / abs(vDir.y) * 143.0;
+      vec3 offsetPos = v_color0.xyz;
+      offsetPos.xz += parallax;
+      vec4 color2 = renderClouds(vDir, offsetPos, v_color1.a, v_color2.a*2.0, v_color2.rgb, v_color1.rgb, v_color0.a);
+      color = mix(color2, color, 0.2 + 0.8*color.a);
+    }
   #endif
 
   #ifdef NL_AURORA
@@ -32,5 +35,9 @@ void main() {
   color.rgb = colorCorrection(color.rgb);
 #endif
 
+#ifdef NL_DEBUG_COST
+  color = vec4(nlCostColor(nlCost), 1.0);
+#endif
+
   gl_FragColor = color;
 }
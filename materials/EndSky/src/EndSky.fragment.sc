@@ -41,7 +41,7 @@ void main() {
     vec3 rainbowColor = getRainbowColor(rotatedTexCoords.x + rotatedTexCoords.y);
 
     // end sky gradient
-    vec3 color = renderEndSky(getEndHorizonCol(), getEndZenithCol(), normalize(v_posTime.xyz), v_posTime.w);
+    vec3 color = renderEndSky(getEndHorizonCol(), getEndZenithCol(), normalize(v_posTime.xyz), nlWrapTime(v_posTime.w, NL_TIME_PERIOD_END));
 
     // Add nebula clouds
     vec3 nebulaClouds = generateNebulaClouds(rotatedTexCoords, v_posTime.w);
@@ -52,5 +52,9 @@ void main() {
 
     color = colorCorrection(color);
 
+#ifdef NL_DEBUG_COST
+    color = nlCostColor(nlCost);
+#endif
+
     gl_FragColor = vec4(color, 1.0);
 }
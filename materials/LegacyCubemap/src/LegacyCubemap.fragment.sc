@@ -1,4 +1,4 @@
-$input v_texcoord0, v_fogColor, v_worldPos, v_underwaterRainTime
+$input v_texcoord0, v_fogColor, v_worldPos, v_underwaterRainTime, v_zenithCol, v_horizonCol, v_horizonEdgeCol
 
 #include <bgfx_shader.sh>
 #include <newb/main.sh>
@@ -9,30 +9,35 @@ void main() {
   vec4 diffuse = texture2D(s_MatTexture, v_texcoord0);
 
   vec3 viewDir = normalize(v_worldPos);
-  bool underWater = v_underwaterRainTime.x > 0.5;
-  float rainFactor = v_underwaterRainTime.y;
-
-  vec3 zenithCol;
-  vec3 horizonCol;
-  vec3 horizonEdgeCol;
-  if (underWater) {
-    vec3 fogcol = getUnderwaterCol(v_fogColor);
-    zenithCol = fogcol;
-    horizonCol = fogcol;
-    horizonEdgeCol = fogcol;
-  } else {
-    vec3 fs = getSkyFactors(v_fogColor);
-    zenithCol = getZenithCol(rainFactor, v_fogColor, fs);
-    horizonCol = getHorizonCol(rainFactor, v_fogColor, fs);
-    horizonEdgeCol = getHorizonEdgeCol(horizonCol, rainFactor, v_fogColor);
-  }
+  float fade = clamp(-10.0*viewDir.y, 0.0, 1.0);
 
-  vec3 skyColor = nlRenderSky(horizonEdgeCol, horizonCol, zenithCol, -viewDir, v_fogColor, v_underwaterRainTime.z, rainFactor, false, underWater, false);
+  // opaque texels hide the sky gradient
+#ifdef NL_CUBEMAP_TRUST_SKY
+  // above the horizon the Sky dome already shows the same gradient
+  bool needSky = diffuse.a < 1.0 && fade > 0.0;
+#else
+  bool needSky = diffuse.a < 1.0;
+#endif
 
-  float fade = clamp(-10.0*viewDir.y, 0.0, 1.0);
-  vec4 color = vec4(colorCorrection(skyColor), fade);
+  if (needSky) {
+    bool underWater = v_underwaterRainTime.x > 0.5;
+    float rainFactor = v_underwaterRainTime.y;
+
+    vec3 skyColor = nlRenderSky(v_horizonEdgeCol, v_horizonCol, v_zenithCol, -viewDir, v_fogColor, v_underwaterRainTime.z, rainFactor, false, underWater, false);
+
+    vec4 color = vec4(colorCorrection(skyColor), fade);
+    diffuse = mix(color, diffuse, diffuse.a);
+  }
+#ifdef NL_CUBEMAP_TRUST_SKY
+  else if (diffuse.a < 1.0) {
+    // alpha the mix above would blend with, given the dome shows the same gradient
+    diffuse.a *= diffuse.a*diffuse.a;
+  }
+#endif
 
-  diffuse = mix(color, diffuse, diffuse.a);
+#ifdef NL_DEBUG_COST
+  diffuse = vec4(nlCostColor(nlCost), 1.0);
+#endif
 
   gl_FragColor = diffuse;
 }
@@ -1,7 +1,10 @@
 vec3 a_position  : POSITION;
 vec2 a_texcoord0 : TEXCOORD0;
 
-vec3 v_fogColor                 : COLOR0;
+flat vec3 v_fogColor            : COLOR0;
 vec3 v_worldPos                 : COLOR1;
-vec3 v_underwaterRainTime       : COLOR2;
+flat vec3 v_underwaterRainTime  : COLOR2;
 vec2 v_texcoord0                : TEXCOORD0;
+flat vec3 v_zenithCol           : TEXCOORD1;
+flat vec3 v_horizonCol          : TEXCOORD2;
+flat vec3 v_horizonEdgeCol      : TEXCOORD3;
@@ -1,5 +1,5 @@
 $input a_position, a_texcoord0
-$output v_texcoord0, v_fogColor, v_worldPos, v_underwaterRainTime
+$output v_texcoord0, v_fogColor, v_worldPos, v_underwaterRainTime, v_zenithCol, v_horizonCol, v_horizonEdgeCol
 
 #include <bgfx_shader.sh>
 #include <newb/main.sh>
@@ -13,7 +13,20 @@ uniform vec4 ViewPositionAndTime;
 void main() {
   v_underwaterRainTime.x = float(detectUnderwater(FogColor.rgb, FogAndDistanceControl.xy));
   v_underwaterRainTime.y = detectRain(FogAndDistanceControl.xyz);
-  v_underwaterRainTime.z = ViewPositionAndTime.w;
+  v_underwaterRainTime.z = nlWrapTime(ViewPositionAndTime.w, NL_TIME_PERIOD_SKY);
+
+  // sky colors only depend on uniforms, so they are the same for the whole draw
+  if (v_underwaterRainTime.x > 0.5) {
+    vec3 fogcol = getUnderwaterCol(FogColor.rgb);
+    v_zenithCol = fogcol;
+    v_horizonCol = fogcol;
+    v_horizonEdgeCol = fogcol;
+  } else {
+    vec3 fs = getSkyFactors(FogColor.rgb);
+    v_zenithCol = getZenithCol(v_underwaterRainTime.y, FogColor.rgb, fs);
+    v_horizonCol = getHorizonCol(v_underwaterRainTime.y, FogColor.rgb, fs);
+    v_horizonEdgeCol = getHorizonEdgeCol(v_horizonCol, v_underwaterRainTime.y, FogColor.rgb);
+  }
 
   v_fogColor = FogColor.rgb;
   v_texcoord0 = a_texcoord0;
@@ -1,4 +1,14 @@
-$input v_color0, v_color1, v_fog, v_refl, v_texcoord0, v_lightmapUV, v_extra
+#if defined(DEPTH_ONLY_OPAQUE) || defined(DEPTH_ONLY)
+  $input v_fog, v_texcoord0
+#elif defined(SEASONS) && (defined(OPAQUE) || defined(ALPHA_TEST))
+  $input v_color0, v_color1, v_fog, v_refl, v_texcoord0, v_extra
+#else
+  $input v_color0, v_fog, v_refl, v_texcoord0, v_extra
+#endif
+#include <newb/config.h>
+#if defined(NL_DEBUG_COST) && !defined(DEPTH_ONLY_OPAQUE) && !defined(DEPTH_ONLY)
+  $input v_cost
+#endif
 
 #include <bgfx_shader.sh>
 #include <newb/main.sh>
@@ -8,15 +18,19 @@ SAMPLER2D(s_SeasonsTexture, 1);
 SAMPLER2D(s_LightMapTexture, 2);
 
 void main() {
-  vec4 diffuse;
-  vec4 color;
+  vec2 uv0 = v_texcoord0.xy;
+  vec2 uv1 = v_texcoord0.zw;
+
+  vec3 lightTint = texture2D(s_LightMapTexture, uv1).rgb;
+  lightTint = mix(lightTint.bbb, lightTint*lightTint, 0.35 + 0.65*uv1.y*uv1.y*uv1.y);
 
 #if defined(DEPTH_ONLY_OPAQUE) || defined(DEPTH_ONLY)
-  diffuse = vec4(1.0,1.0,1.0,1.0);
-  color = vec4(1.0,1.0,1.0,1.0);
+  // no texture, glow or reflection in depth passes
+  vec4 diffuse = vec4(lightTint, 1.0);
 #else
-diffuse.rgb = texture2D(s_MatTexture, v_texcoord0).rgb;
-  diffuse.a = texture2DLod(s_MatTexture, v_texcoord0, 0.0).a;
+  vec4 diffuse;
+  diffuse.rgb = texture2D(s_MatTexture, uv0).rgb;
+  diffuse.a = texture2DLod(s_MatTexture, uv0, 0.0).a;
 #ifdef ALPHA_TEST
   if (diffuse.a < 0.6) {
     discard;
@@ -26,20 +40,22 @@ diffuse.rgb = texture2D(s_MatTexture, v_texcoord0).rgb;
 #if defined(SEASONS) && (defined(OPAQUE) || defined(ALPHA_TEST))
   diffuse.rgb *= mix(vec3(1.0,1.0,1.0), texture2D(s_SeasonsTexture, v_color1.xy).rgb * 2.0, v_color1.z);
 #endif
-  color = v_color0;
+  vec4 color = v_color0;
+#ifdef TRANSPARENT
+  bool water = v_extra.x > 0.9;
+#else
+  bool water = false;
 #endif
+  float shimmer = v_extra.y;
 
   diffuse.rgb *= diffuse.rgb;
 
-  vec3 lightTint = texture2D(s_LightMapTexture, v_lightmapUV).rgb;
-  lightTint = mix(lightTint.bbb, lightTint*lightTint, 0.35 + 0.65*v_lightmapUV.y*v_lightmapUV.y*v_lightmapUV.y);
-
   color.rgb *= lightTint;
 
-  vec3 glow = nlGlow(s_MatTexture, v_texcoord0, diffuse, v_extra.a);
+  vec3 glow = nlGlow(s_MatTexture, uv0, diffuse, shimmer);
 
 #ifdef TRANSPARENT
-  if (v_extra.b > 0.9) {
+  if (water) {
     diffuse.rgb = vec3_splat(1.0 - NL_WATER_TEX_OPACITY*(1.0 - diffuse.b*1.8));
     diffuse.a = color.a;
   }
@@ -50,21 +66,24 @@ diffuse.rgb = texture2D(s_MatTexture, v_texcoord0).rgb;
   diffuse.rgb *= color.rgb;
   diffuse.rgb += glow;
 
-  if (v_extra.b > 0.9) {
+  // outside the branch, derivatives are undefined in non-uniform control flow
+  float dy = dFdy(v_extra.z);
+  if (water) {
+    diffuse.rgb += v_refl.rgb*v_refl.a;
+  } else if (v_refl.a > 0.0 && nlFlatFace(dy)) {
+    // ground reflection - only on xz plane
+    diffuse.rgb *= 1.0 - 0.6*v_refl.a;
     diffuse.rgb += v_refl.rgb*v_refl.a;
-  } else if (v_refl.a > 0.0) {
-    // reflective effect - only on xz plane
-    float dy = abs(dFdy(v_extra.g));
-    if (dy < 0.0002) {
-      float mask = v_refl.a*(clamp(v_extra.r*10.0,8.2,8.8)-7.8);
-      diffuse.rgb *= 1.0 - 0.6*mask;
-      diffuse.rgb += v_refl.rgb*mask;
-    }
   }
+#endif
 
   diffuse.rgb = mix(diffuse.rgb, v_fog.rgb, v_fog.a);
 
   diffuse.rgb = colorCorrection(diffuse.rgb);
 
+#if defined(NL_DEBUG_COST) && !defined(DEPTH_ONLY_OPAQUE) && !defined(DEPTH_ONLY)
+  diffuse = vec4(nlCostColor(v_cost + nlCost), 1.0);
+#endif
+
   gl_FragColor = diffuse;
 }
\ No newline at end of file
@@ -12,7 +12,7 @@ vec4 v_color0     : COLOR0;
 vec4 v_color1     : COLOR1;
 vec4 v_fog        : COLOR2;
 vec4 v_refl       : COLOR3;
-centroid vec2 v_texcoord0  : TEXCOORD0;
-vec2 v_lightmapUV : TEXCOORD1;
+centroid vec4 v_texcoord0  : TEXCOORD0;
 vec3 v_position   : TEXCOORD2;
-vec4 v_extra      : TEXCOORD3;
+vec3 v_extra      : TEXCOORD3;
+float v_cost      : TEXCOORD1;
@@ -2,7 +2,19 @@ $input a_color0, a_position, a_texcoord0, a_texcoord1
 #ifdef INSTANCING
   $input i_data0, i_data1, i_data2, i_data3
 #endif
-$output v_color0, v_color1, v_fog, v_refl, v_texcoord0, v_lightmapUV, v_extra
+// outputs the fragment shader of this pass reads, v_texcoord0 = (uv0, lightmap uv)
+#if defined(DEPTH_ONLY_OPAQUE) || defined(DEPTH_ONLY)
+  $output v_fog, v_texcoord0
+#elif defined(SEASONS) && (defined(OPAQUE) || defined(ALPHA_TEST))
+  $output v_color0, v_color1, v_fog, v_refl, v_texcoord0, v_extra
+#else
+  $output v_color0, v_fog, v_refl, v_texcoord0, v_extra
+#endif
+// vertex cost for the heatmap of the DEBUG_COST subpack
+#include <newb/config.h>
+#if defined(NL_DEBUG_COST) && !defined(DEPTH_ONLY_OPAQUE) && !defined(DEPTH_ONLY)
+  $output v_cost
+#endif
 
 #include <bgfx_shader.sh>
 #include <newb/main.sh>
@@ -44,6 +56,9 @@ void main() {
 
   float relativeDist = camDis / FogAndDistanceControl.z;
 
+  // near/mid/far tier weights
+  vec2 lod = nlLod(relativeDist);
+
   vec3 cPos = a_position.xyz;
   vec3 bPos = fract(cPos);
   vec3 tiledCpos = fract(cPos*0.0625);
@@ -51,16 +66,12 @@ void main() {
   vec2 uv1 = a_texcoord1;
   vec2 lit = uv1*uv1;
 
-  bool isColored = color.r != color.g || color.r != color.b;
+  // tint, tree leaves and wave shapes of this vertex (blocks.h)
+  int block = nlBlockClass(color, bPos, a_texcoord0);
+  bool isColored = nlBlockIs(block, NL_BLOCK_COLORED);
+  bool isTree = nlBlockIs(block, NL_BLOCK_TREE);
   float shade = isColored ? color.g*1.5 : color.g;
 
-  // tree leaves detection
-#ifdef ALPHA_TEST
-  bool isTree = (isColored && (bPos.x+bPos.y+bPos.z < 0.001)) || color.a == 0.0;
-#else
-  bool isTree = false;
-#endif
-
   // environment detections
   bool end = detectEnd(FogColor.rgb, FogAndDistanceControl.xy);
   bool nether = detectNether(FogColor.rgb, FogAndDistanceControl.xy);
@@ -92,8 +103,6 @@ void main() {
 
 // convert color space to linear-space
 #ifdef SEASONS
-  isTree = true;
-
   // season tree leaves are colored in fragment
   color.w *= color.w;
   color = vec4(color.www, 1.0);
@@ -105,11 +114,17 @@ void main() {
 
   vec3 torchColor; // modified by nl_lighting
   vec3 light = nlLighting(
-    worldPos, torchColor, a_color0.rgb, FogColor.rgb, rainFactor,uv1, lit, isTree, horizonCol, zenithCol, shade, end, nether, underWater, t
+    worldPos, torchColor, a_color0.rgb, FogColor.rgb, rainFactor,uv1, lit, isTree, horizonCol, zenithCol, shade, end, nether, underWater, t, lod.x
   );
 
 #if defined(ALPHA_TEST) && (defined(NL_PLANTS_WAVE) || defined(NL_LANTERN_WAVE))
-  nlWave(worldPos, light, rainFactor, uv1, lit, a_texcoord0, bPos, a_color0, cPos, tiledCpos, t, isColored, camDis, isTree);
+  if (lod.x < 1.0) {
+    vec3 wavePos = worldPos;
+    vec3 waveLight = light;
+    nlWave(wavePos, waveLight, rainFactor, uv1, lit, a_texcoord0, bPos, cPos, tiledCpos, t, camDis, block);
+    worldPos = mix(wavePos, worldPos, lod.x);
+    light = mix(waveLight, light, lod.x);
+  }
 #endif
 
 #ifdef NL_CHUNK_LOAD_ANIM
@@ -121,16 +136,25 @@ void main() {
   relativeDist += RenderChunkFogAlpha.x;
 
   vec4 fogColor;
-  fogColor.rgb = nlRenderSky(horizonEdgeCol, horizonCol, zenithCol, viewDir, FogColor.rgb, t, rainFactor, end, underWater, nether);
   fogColor.a = nlRenderFogFade(relativeDist, FogColor.rgb, FogAndDistanceControl.xy);
   #ifdef NL_GODRAY 
-    fogColor.a = mix(fogColor.a, 1.0, NL_GODRAY*nlRenderGodRayIntensity(cPos, worldPos, t, uv1, relativeDist, FogColor.rgb));
+  if (lod.y < 1.0) {
+    fogColor.a = mix(fogColor.a, 1.0, (1.0-lod.y)*NL_GODRAY*nlRenderGodRayIntensity(cPos, worldPos, t, uv1, relativeDist, FogColor.rgb));
+  }
   #endif
 
+  // dimension flags come from uniforms, so each branch is taken by the whole draw
   if (nether) {
-    // blend fog with void color
+    // blend fog with void color, sky is not visible
     fogColor.rgb = colorCorrectionInv(FogColor.rgb);
     fogColor.rgb = mix(fogColor.rgb, vec3(0.8,0.2,0.12)*1.5, lit.x*(1.67-fogColor.a*1.67));
+  } else if (lod.y < 1.0) {
+    fogColor.rgb = nlRenderSky(horizonEdgeCol, horizonCol, zenithCol, viewDir, FogColor.rgb, t, rainFactor, end, underWater, nether);
+    if (lod.y > 0.0) {
+      fogColor.rgb = mix(fogColor.rgb, nlRenderSkyFar(horizonEdgeCol, horizonCol, zenithCol, viewDir, t, end, underWater), lod.y);
+    }
+  } else {
+    fogColor.rgb = nlRenderSkyFar(horizonEdgeCol, horizonCol, zenithCol, viewDir, t, end, underWater);
   }
 
   vec4 refl = vec4(0.0,0.0,0.0,0.0);
@@ -153,19 +177,19 @@ void main() {
     water = 0.0;
     pos = mul(u_viewProj, vec4(worldPos, 1.0));
     refl = nlRefl(
-      color, fogColor, lit, uv1, tiledCpos, camDis, worldPos, viewDir, torchColor, horizonEdgeCol, horizonCol, zenithCol, FogColor.rgb, rainFactor, FogAndDistanceControl.z, t, pos.xyz, underWater, end, nether
+      color, fogColor, lit, uv1, tiledCpos, nlReflShade(shade), camDis, worldPos, viewDir, torchColor, horizonEdgeCol, horizonCol, zenithCol, FogColor.rgb, rainFactor, FogAndDistanceControl.z, t, pos.xyz, underWater, end, nether
     );
   }
 #else
   float water = 0.0;
   pos = mul(u_viewProj, vec4(worldPos, 1.0));
   refl = nlRefl(
-    color, fogColor, lit, uv1, tiledCpos, camDis, worldPos, viewDir, torchColor, horizonEdgeCol, horizonCol, zenithCol, FogColor.rgb, rainFactor, FogAndDistanceControl.z, t, pos.xyz, underWater, end, nether
+    color, fogColor, lit, uv1, tiledCpos, nlReflShade(shade), camDis, worldPos, viewDir, torchColor, horizonEdgeCol, horizonCol, zenithCol, FogColor.rgb, rainFactor, FogAndDistanceControl.z, t, pos.xyz, underWater, end, nether
   );
 #endif
 
   if (underWater) {
-    nlUnderwaterLighting(light, pos.xyz, lit, uv1, tiledCpos, cPos, t, horizonEdgeCol);
+    nlUnderwaterLighting(light, pos.xyz, lit, uv1, tiledCpos, cPos, t, horizonEdgeCol, lod.x);
   }
 #else
   float water = 0.0;
@@ -180,12 +204,18 @@ void main() {
   float shimmer = 0.0;
   #endif
 
-  v_extra = vec4(shade, worldPos.y, water, shimmer);
+  v_texcoord0 = vec4(a_texcoord0, a_texcoord1);
+  v_fog = fogColor;
+#if !defined(DEPTH_ONLY_OPAQUE) && !defined(DEPTH_ONLY)
   v_refl = refl;
-  v_texcoord0 = a_texcoord0;
-  v_lightmapUV = a_texcoord1;
   v_color0 = color;
+  v_extra = vec3(water, shimmer, worldPos.y);
+#if defined(SEASONS) && (defined(OPAQUE) || defined(ALPHA_TEST))
   v_color1 = a_color0;
-  v_fog = fogColor;
+#endif
+#ifdef NL_DEBUG_COST
+  v_cost = nlCost;
+#endif
+#endif
   gl_Position = pos;
 }
@@ -7,7 +7,10 @@ vec4 i_data1        : TEXCOORD7;
 vec4 i_data2        : TEXCOORD6;
 vec4 i_data3        : TEXCOORD5;
 
-vec3 v_fogColor                 : COLOR0;
+flat vec3 v_fogColor            : COLOR0;
 vec3 v_worldPos                 : COLOR1;
-vec3 v_underwaterRainTime       : COLOR2;
+flat vec4 v_underwaterRainTime  : COLOR2;
 vec3 sPos                       : COLOR3;
+flat vec3 v_zenithCol           : TEXCOORD0;
+flat vec3 v_horizonCol          : TEXCOORD1;
+flat vec3 v_horizonEdgeCol      : TEXCOORD2;
@@ -1,6 +1,6 @@
 $input a_color0, a_position
 #ifdef OPAQUE
-$output v_fogColor, v_worldPos, v_underwaterRainTime, sPos
+$output v_fogColor, v_worldPos, v_underwaterRainTime, sPos, v_zenithCol, v_horizonCol, v_horizonEdgeCol
 #endif
 
 #include <bgfx_shader.sh>
@@ -23,6 +23,20 @@ void main() {
   v_underwaterRainTime.x = float(detectUnderwater(FogColor.rgb, FogAndDistanceControl.xy));
   v_underwaterRainTime.y = detectRain(FogAndDistanceControl.xyz);
   v_underwaterRainTime.z = ViewPositionAndTime.w;
+  v_underwaterRainTime.w = nlWrapTime(ViewPositionAndTime.w, NL_TIME_PERIOD_SKY);
+
+  // sky colors only depend on uniforms, so they are the same for the whole draw
+  if (v_underwaterRainTime.x > 0.5) {
+    vec3 fogcol = getUnderwaterCol(FogColor.rgb);
+    v_zenithCol = fogcol;
+    v_horizonCol = fogcol;
+    v_horizonEdgeCol = fogcol;
+  } else {
+    vec3 fs = getSkyFactors(FogColor.rgb);
+    v_zenithCol = getZenithCol(v_underwaterRainTime.y, FogColor.rgb, fs);
+    v_horizonCol = getHorizonCol(v_underwaterRainTime.y, FogColor.rgb, fs);
+    v_horizonEdgeCol = getHorizonEdgeCol(v_horizonCol, v_underwaterRainTime.y, FogColor.rgb);
+  }
 
   v_fogColor = FogColor.rgb;
   v_worldPos = mul(u_model[0], vec4(pos, 1.0)).xyz;
@@ -6,6 +6,9 @@
 # - bash on windows: (windows and android pack)
 #     pack.sh -w -v 15.0 -m "Custom name (optional)" -p Windows
 #     pack.sh -w -v 15.0 -m "Custom name (optional)" -p Android
+# - j: number of materials to build at once (default: core count)
+# - b: compile all materials in one java process (build.sh only)
+# - d: include the development subpacks (DEV_SUBPACKS of pack_config.sh, eg. DEBUG_COST)
 
 # load pack config
 source include/newb/pack_config.sh
@@ -13,7 +16,11 @@ source include/newb/pack_config.sh
 BUILD_SCRIPT="./build.sh"
 PACK_DIR="pack"
 CONFIG_FILE="include/newb/config.h"
+GLOW_BAKE_TOLERANCE=0.02 # largest mean error of a baked texture, about 5 of 255 display steps at mid gray
 PLATFORM="Android"
+JOBS=$(nproc --all)
+BATCH=0
+DEV=0
 
 # version format: tag.commits
 VERSION=15.0
@@ -34,11 +41,15 @@ for t in "$@"; do
   if [ "${t:0:1}" == "-" ]; then
     # mode
     OPT=${t:1}
-    if [[ "$OPT" =~ ^[pmv]$ ]]; then
+    if [[ "$OPT" =~ ^[pmvj]$ ]]; then
       ARG_MODE=$OPT
     elif [ "$OPT" == "w" ]; then  
       # using bash on win
       BUILD_SCRIPT="./build.bat"
+    elif [ "$OPT" == "b" ]; then
+      BATCH=1
+    elif [ "$OPT" == "d" ]; then
+      DEV=1
     else
       echo "Invalid option: $t"      
       exit 1
@@ -49,10 +60,16 @@ for t in "$@"; do
     MSG="- §b$t"
   elif [ "$ARG_MODE" == "p" ]; then
     PLATFORM="$t"
+  elif [ "$ARG_MODE" == "j" ]; then
+    JOBS="$t"
   fi
   shift
 done
 
+if [ "$BUILD_SCRIPT" == "./build.bat" ]; then
+  # native MaterialBinTool, no jvm start-up to save
+  BATCH=0
+fi
 BUILD_SCRIPT="$BUILD_SCRIPT -p $PLATFORM"
 BUILD_DIR="build/$PLATFORM"
 TEMP_PACK_DIR="$BUILD_DIR/temp"
@@ -62,6 +79,16 @@ ERRORS=0
 echo ">> Pack directory: $TEMP_PACK_DIR"
 mkdir -p $TEMP_PACK_DIR/renderer/materials
 cp -ru $PACK_DIR/* $TEMP_PACK_DIR
+# fresh manifest, the subpack list of this run is added to it below
+cp $PACK_DIR/manifest.json $MANIFEST
+
+# undo textures baked by a previous run
+cp -r $PACK_DIR/textures/blocks/* $TEMP_PACK_DIR/textures/blocks/
+if grep -q "^\s*#define NL_GLOW_BAKED" $CONFIG_FILE; then
+  # textures are shared, fails unless every subpack bakes the same leak
+  echo ">> Baking glow leak into block textures"
+  python3 tools/glow_bake.py $PACK_DIR/textures/blocks $TEMP_PACK_DIR/textures/blocks -c $CONFIG_FILE -s ${SUBPACK_OPTIONS[@]} -t $GLOW_BAKE_TOLERANCE || ERRORS=$((ERRORS+1))
+fi
 
 echo ">> Updating manifest.json"
 if [ "$PLATFORM" == "Windows" ]; then
@@ -74,16 +101,44 @@ sed -i "s/\"version\": \[.*]/\"version\": [0, ${VERSION/./, }]/g" $MANIFEST
 sed -i "s/\%v/v$VERSION ${PLATFORM^}/g" $MANIFEST
 echo -e "   - platform: $PLATFORM\n   - version: 0.$VERSION\n   - message: ${MSG:4}"
 
-echo ">> Building default materials"
-rm -f $BUILD_DIR/*.material.bin
-$BUILD_SCRIPT -m $DEFAULT_MATERIALS 2>&1 | tee ./build/.tmp-log.txt
-CMD_OUTPUT=$(< ./build/.tmp-log.txt)
-if [[ $CMD_OUTPUT =~ "Compilation failed" ]]; then
-  ERRORS=$((ERRORS+1))
+# include dir of the default pack, with the headers generated from config.h (tools/generate.sh)
+# made once before any job starts, the source tree is never written
+BASE_INCLUDE=$BUILD_DIR/include/base
+rm -rf $BASE_INCLUDE
+mkdir -p $BASE_INCLUDE
+cp -r include/* $BASE_INCLUDE/
+tools/generate.sh $BASE_INCLUDE || ERRORS=$((ERRORS+1))
+
+# generated include dir with the subpack option defined on config.h line 3
+variant_include() {
+  local dir=$BUILD_DIR/include/${1,,}
+  rm -rf $dir
+  mkdir -p $dir
+  cp -r $BASE_INCLUDE/* $dir/
+  sed -i "3s/.*/#define $1 \/\/ generated by pack.sh/" $dir/newb/config.h
+  echo $dir
+}
+
+# build jobs: "<name> <material> <include dir> <output dir>"
+BUILD_JOBS=()
+rm -f $TEMP_PACK_DIR/renderer/materials/*.material.bin
+for m in $DEFAULT_MATERIALS; do
+  BUILD_JOBS+=("default $m $BASE_INCLUDE $TEMP_PACK_DIR/renderer/materials")
+done
+
+if [ $DEV == 0 ]; then
+  # release pack, without the development subpacks
+  for ((s=${#SUBPACK_OPTIONS[@]}-1; s>=0; s-=1)); do
+    if [[ " $DEV_SUBPACKS " == *" ${SUBPACK_OPTIONS[s]} "* ]]; then
+      rm -rf $TEMP_PACK_DIR/subpacks/${SUBPACK_OPTIONS[s],,}
+      unset "SUBPACK_OPTIONS[s]" "SUBPACK_NAMES[s]" "SUBPACK_MATERIALS[s]"
+    fi
+  done
+  SUBPACK_OPTIONS=("${SUBPACK_OPTIONS[@]}")
+  SUBPACK_NAMES=("${SUBPACK_NAMES[@]}")
+  SUBPACK_MATERIALS=("${SUBPACK_MATERIALS[@]}")
 fi
-mv -f $BUILD_DIR/*.material.bin $TEMP_PACK_DIR/renderer/materials/
 
-echo ">> Building subpack materials"
 SUBPACK_COUNT=${#SUBPACK_OPTIONS[@]}
 CONTENT=
 for ((s=0; s<$SUBPACK_COUNT; s+=1)); do
@@ -91,20 +146,13 @@ for ((s=0; s<$SUBPACK_COUNT; s+=1)); do
   S_MATS=${SUBPACK_MATERIALS[s]}
   S_DIR=$TEMP_PACK_DIR/subpacks/${OPTION,,}/renderer/materials
   mkdir -p $S_DIR
-  echo -n "   - ${OPTION}: "
+  rm -f $S_DIR/*.material.bin
 
-  if [ -z "$S_MATS" ]; then
-    echo "done"
-  else
-    sed -i "3s/.*/#define $OPTION \/\/ generated by pack.sh/" $CONFIG_FILE
-    STAT=$($BUILD_SCRIPT -m $S_MATS)
-    if [[ $STAT =~ "Compilation failed" ]]; then
-      ERRORS=$((ERRORS+1))
-      echo "failed"
-    else
-      mv $BUILD_DIR/*.material.bin $S_DIR
-      echo "done"
-    fi
+  if [ -n "$S_MATS" ]; then
+    S_INCLUDE=$(variant_include $OPTION)
+    for m in ${S_MATS//;/ }; do
+      BUILD_JOBS+=("${OPTION,,} $m $S_INCLUDE $S_DIR")
+    done
   fi
 
   # quote special chars used by sed
@@ -113,8 +161,94 @@ for ((s=0; s<$SUBPACK_COUNT; s+=1)); do
   CONTENT="$CONTENT        {\"folder_name\": \"${OPTION,,}\", \"name\": \"$DESCRIPTION\", \"memory_tier\": 1},\n"
 done
 
+# split cores between the jobs that run at once
+RUNNING=$(( ${#BUILD_JOBS[@]} < JOBS ? ${#BUILD_JOBS[@]} : JOBS ))
+THREADS=$(( $(nproc --all) / (RUNNING > 0 ? RUNNING : 1) ))
+THREADS=$(( THREADS > 0 ? THREADS : 1 ))
+
+echo ">> Building ${#BUILD_JOBS[@]} materials ($JOBS jobs, $THREADS threads each)"
+LOG_DIR=$BUILD_DIR/logs
+rm -rf $LOG_DIR
+mkdir -p $LOG_DIR
+if [ $BATCH == 1 ]; then
+  # one job list for build.sh, compiled by a single java process
+  for job in "${BUILD_JOBS[@]}"; do
+    read -r NAME M S_INCLUDE S_DIR <<< "$job"
+    echo "materials/$M $S_INCLUDE $S_DIR"
+  done > $LOG_DIR/jobs.txt
+  $BUILD_SCRIPT -b -l $LOG_DIR/jobs.txt -t $THREADS 2>&1 | tee $LOG_DIR/batch.txt
+else
+  for job in "${BUILD_JOBS[@]}"; do
+    read -r NAME M S_INCLUDE S_DIR <<< "$job"
+    while [ $(jobs -rp | wc -l) -ge $JOBS ]; do
+      wait -n
+    done
+    $BUILD_SCRIPT -m $M -i $S_INCLUDE -o $S_DIR -t $THREADS > $LOG_DIR/$NAME-$M.txt 2>&1 &
+  done
+  wait
+
+  # build output of default materials
+  cat $LOG_DIR/default-*.txt 2> /dev/null
+fi
+
+for NAME in $(printf "%s\n" "${BUILD_JOBS[@]}" | cut -d' ' -f1 | uniq); do
+  MISSING=""
+  for job in "${BUILD_JOBS[@]}"; do
+    read -r N M S_INCLUDE S_DIR <<< "$job"
+    if [ "$N" == "$NAME" ] && [ ! -f "$S_DIR/$M.material.bin" ]; then
+      MISSING+=" $M"
+    fi
+  done
+  if [ -n "$MISSING" ]; then
+    ERRORS=$((ERRORS+1))
+    echo "   - $NAME: failed:$MISSING (see $LOG_DIR/)"
+  else
+    echo "   - $NAME: done"
+  fi
+done
+# subpacks without materials of their own (eg. DEFAULT) use the default pack's
+for ((s=0; s<$SUBPACK_COUNT; s+=1)); do
+  if [ -z "${SUBPACK_MATERIALS[s]}" ]; then
+    echo "   - ${SUBPACK_OPTIONS[s],,}: same as default"
+  fi
+done
+
+# drop subpack materials identical to the default pack, the game falls back to it
+echo ">> Subpack sizes (identical materials are left to the default pack)"
+BASE_DIR=$TEMP_PACK_DIR/renderer/materials
+declare -A BASE_HASH
+for f in $BASE_DIR/*.material.bin; do
+  BASE_HASH[${f##*/}]=$(sha256sum < $f | cut -c1-16)
+done
+SAVED=0
+for OPTION in ${SUBPACK_OPTIONS[@],,}; do
+  S_DIR=$TEMP_PACK_DIR/subpacks/$OPTION/renderer/materials
+  KEPT=0
+  DROPPED=0
+  DROPPED_NAMES=""
+  for f in $S_DIR/*.material.bin; do
+    if [ ! -f "$f" ]; then
+      continue
+    fi
+    SIZE=$(stat -c %s $f)
+    if [ "$(sha256sum < $f | cut -c1-16)" == "${BASE_HASH[${f##*/}]}" ]; then
+      rm $f
+      DROPPED=$((DROPPED+SIZE))
+      DROPPED_NAMES+=" ${f##*/}"
+    else
+      KEPT=$((KEPT+SIZE))
+    fi
+  done
+  SAVED=$((SAVED+DROPPED))
+  printf "   - %-12s %6d KB" $OPTION $((KEPT/1024))
+  if [ $DROPPED -gt 0 ]; then
+    printf ", dropped %d KB:%s" $((DROPPED/1024)) "${DROPPED_NAMES//.material.bin/}"
+  fi
+  echo
+done
+echo "   - saved $((SAVED/1024)) KB"
+
 sed -i "s/\"metadata/\"subpacks\": [\n${CONTENT%,*}\n     ],\n    \"metadata/" $MANIFEST
-sed -i "3s/.*/\/\/ line 3 reserved/" $CONFIG_FILE
 
 # pack if zip exists
 if command -v zip &> /dev/null; then
@@ -0,0 +1,66 @@
+#!/bin/bash
+
+# Static shader cost report for a built pack (run pack.sh first)
+# usage:
+#   report.sh -p Android -o build/cost.tsv     # save table
+#   report.sh -p Android -b build/cost.tsv     # diff against saved table
+#   report.sh -p Android -b build/cost.tsv -t 5
+#   - p: platform of the built pack (must produce GLSL/ESSL, eg. Android)
+#   - o: write full table (tsv)
+#   - b: baseline table to diff against, exits non-zero on regressions
+#   - t: allowed growth of a metric in percent (default 10)
+
+MBT_JAR_FILES=(env/jar/MaterialBinTool-0.9*.jar)
+MBT_JAR="java -jar ${MBT_JAR_FILES[0]}"
+
+PLATFORM="Android"
+COST_ARGS=""
+
+ARG_MODE=""
+for t in "$@"; do
+  if [ "${t:0:1}" == "-" ]; then
+    OPT=${t:1}
+    if [[ "$OPT" =~ ^[pobt]$ ]]; then
+      ARG_MODE=$OPT
+    else
+      echo "Invalid option: $t"
+      exit 1
+    fi
+  elif [ "$ARG_MODE" == "p" ]; then
+    PLATFORM="$t"
+  else
+    COST_ARGS+="-$ARG_MODE $t "
+  fi
+  shift
+done
+
+PACK_DIR="build/$PLATFORM/temp"
+REPORT_DIR="build/$PLATFORM/report"
+
+if [ ! -d "$PACK_DIR/renderer/materials" ]; then
+  echo "Error: $PACK_DIR not found, run pack.sh -p $PLATFORM first"
+  exit 1
+fi
+
+echo ">> Unpacking materials to $REPORT_DIR"
+rm -rf $REPORT_DIR
+mkdir -p $REPORT_DIR/default
+cp $PACK_DIR/renderer/materials/*.material.bin $REPORT_DIR/default/
+for s in $PACK_DIR/subpacks/*/renderer/materials; do
+  S_NAME=${s#$PACK_DIR/subpacks/}
+  S_NAME=${S_NAME%%/*}
+  if ls $s/*.material.bin &> /dev/null; then
+    mkdir -p $REPORT_DIR/$S_NAME
+    cp $s/*.material.bin $REPORT_DIR/$S_NAME/
+  fi
+done
+
+for f in $REPORT_DIR/*/*.material.bin; do
+  M_DIR=${f%.material.bin}
+  mkdir -p $M_DIR
+  mv $f $M_DIR/
+  $MBT_JAR --unpack $M_DIR/${f##*/} > /dev/null || echo "Error: failed to unpack $f"
+done
+
+echo ">> Shader cost ($PLATFORM)"
+python3 tools/shader_cost.py $REPORT_DIR $COST_ARGS
@@ -0,0 +1,81 @@
+#!/usr/bin/env python3
+"""Checks that the terrainVertex benchmark of tools/cpu/bench.cpp still does
+what RenderChunk.vertex.sc does.
+
+bench.cpp copies the vertex shader by hand, with scene inputs taken from
+the sample instead of attributes and uniforms. This compares the order of
+the include/newb function calls in the Opaque pass of the shader (default
+config) with the calls in terrainVertex, leaving out the calls that only
+compute inputs the sample already has (SAMPLE_INPUTS).
+Exits non-zero and prints both lists when they differ.
+
+usage: bench_sync.py [-D DEFINE]...
+"""
+
+import argparse
+import difflib
+import re
+import subprocess
+import sys
+
+SHADER = 'materials/RenderChunk/src/RenderChunk.vertex.sc'
+BENCH = 'tools/cpu/bench.cpp'
+FUNCTIONS = 'include/newb/functions'
+PASS_DEFINES = ['OPAQUE']
+
+# computed by the shader from attributes and uniforms, members of Sample in bench.cpp
+SAMPLE_INPUTS = {
+    'nlBlockClass', 'nlBlockIs', 'detectEnd', 'detectNether', 'detectUnderwater', 'detectRain',
+    'getUnderwaterCol', 'getEndZenithCol', 'getEndHorizonCol', 'getSkyFactors', 'getZenithCol',
+    'getHorizonCol', 'getHorizonEdgeCol', 'nlCostColor',
+}
+
+
+def newb_functions():
+    names = set()
+    out = subprocess.run('cat %s/*.h' % FUNCTIONS, shell=True, capture_output=True, text=True).stdout
+    for m in re.finditer(r'^\s*(?:highp\s+|mediump\s+|lowp\s+)?\w+\s+(\w+)\s*\([^;{]*\)\s*\{', out, re.M):
+        names.add(m.group(1))
+    return names
+
+
+def calls(text, names):
+    return [m.group(1) for m in re.finditer(r'\b(\w+)\s*\(', text) if m.group(1) in names and m.group(1) not in SAMPLE_INPUTS]
+
+
+def shader_body(defines):
+    src = open(SHADER).read()
+    # bgfx directives and headers the preprocessor here cannot resolve
+    src = re.sub(r'^\s*\$(input|output).*$', '', src, flags=re.M)
+    src = re.sub(r'^\s*#\s*include\s*<(bgfx_shader\.sh|newb/main\.sh)>.*$', '', src, flags=re.M)
+    args = ['cpp', '-P', '-undef', '-nostdinc', '-I', 'include'] + ['-D%s' % d for d in PASS_DEFINES + defines]
+    out = subprocess.run(args, input=src, capture_output=True, text=True, check=True).stdout
+    return out[out.index('void main()'):]
+
+
+def bench_body():
+    src = open(BENCH).read()
+    start = src.index('run("terrainVertex"')
+    return src[start:src.index('\n  });', start)]
+
+
+def main():
+    parser = argparse.ArgumentParser(description='Compare terrainVertex of bench.cpp with RenderChunk.vertex.sc')
+    parser.add_argument('-D', dest='defines', action='append', default=[], help='extra define, eg. a subpack option')
+    args = parser.parse_args()
+
+    names = newb_functions()
+    shader = calls(shader_body(args.defines), names)
+    bench = calls(bench_body(), names)
+    if shader == bench:
+        print('>> terrainVertex matches %s (%d calls)' % (SHADER, len(shader)))
+        return 0
+
+    print('Error: terrainVertex in %s differs from %s, update it:' % (BENCH, SHADER))
+    for line in difflib.unified_diff(shader, bench, 'shader', 'bench', lineterm='', n=2):
+        print('  ' + line)
+    return 1
+
+
+if __name__ == '__main__':
+    sys.exit(main())
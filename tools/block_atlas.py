@@ -0,0 +1,114 @@
+#!/usr/bin/env python3
+"""Generate the texture atlas tables of blocks.h from an atlas description.
+
+Reads a per Minecraft version description (tools/atlas/<version>.txt) of
+which atlas tiles hold plants that wave only in part, and writes
+block_atlas.h: one table with 2 bits per tile, 15 tiles per int (bit 31 is
+left alone, so every value is a plain positive int). The table is written
+as a GLSL array constructor, or an initializer list for HLSL. It starts
+at the first described tile and ends at the last one, nlAtlasClass reads
+one int and shifts, no branches.
+
+Classes: 0 default, 1 still, 2 top, 3 bottom (see the description files).
+A tile listed twice is an error.
+"""
+
+import argparse
+import os
+import re
+import sys
+
+CLASSES = {'still': 1, 'top': 2, 'bottom': 3}
+TILES = 32*64
+TILES_PER_WORD = 15
+
+
+def read_description(path):
+    tiles = {}
+    with open(path) as f:
+        for n, line in enumerate(f, 1):
+            line = line.split('#')[0].strip()
+            if not line:
+                continue
+            m = re.match(r'(\w+)\s+(\d+)(?:-(\d+))?$', line)
+            if not m or m.group(1) not in CLASSES:
+                sys.exit('Error: %s:%d: expected "<still|top|bottom> <tile>[-<last tile>]"' % (path, n))
+            first = int(m.group(2))
+            last = int(m.group(3) or first)
+            if last < first or last >= TILES:
+                sys.exit('Error: %s:%d: bad tile range %d-%d' % (path, n, first, last))
+            for tile in range(first, last + 1):
+                if tile in tiles:
+                    sys.exit('Error: %s:%d: tile %d is already listed' % (path, n, tile))
+                tiles[tile] = CLASSES[m.group(1)]
+    if not tiles:
+        sys.exit('Error: %s lists no tiles' % path)
+    return tiles
+
+
+def pack(tiles):
+    first = min(tiles)
+    count = max(tiles) - first + 1
+    words = [0]*((count + TILES_PER_WORD - 1)//TILES_PER_WORD)
+    for tile, cls in tiles.items():
+        i = tile - first
+        words[i//TILES_PER_WORD] |= cls << (2*(i % TILES_PER_WORD))
+    return first, words
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.split('\n')[0])
+    parser.add_argument('src', help='atlas description (eg. tools/atlas/1.20.40.txt)')
+    parser.add_argument('-o', dest='out', help='header to write (eg. <include copy>/newb/functions/block_atlas.h, see tools/generate.sh)')
+    args = parser.parse_args()
+
+    if not os.path.isfile(args.src):
+        sys.exit('Error: %s not found' % args.src)
+
+    tiles = read_description(args.src)
+    first, words = pack(tiles)
+    counts = {name: sum(1 for c in tiles.values() if c == v) for name, v in CLASSES.items()}
+    print('%s: %s tiles, %d ints from tile %d' % (
+        os.path.basename(args.src), ', '.join('%d %s' % (counts[n], n) for n in CLASSES), len(words), first))
+
+    if args.out:
+        rows = []
+        for i in range(0, len(words), 8):
+            rows.append('  ' + ', '.join(str(w) for w in words[i:i + 8]))
+        lines = [
+            '#ifndef BLOCK_ATLAS_H',
+            '#define BLOCK_ATLAS_H',
+            '',
+            '/* Generated by tools/block_atlas.py from %s, do not edit.' % os.path.basename(args.src),
+            ' * Wave class of atlas tiles from NL_ATLAS_FIRST on, 2 bits per tile,',
+            ' * %d tiles per int: 0 default, 1 still, 2 top, 3 bottom.' % TILES_PER_WORD,
+            ' */',
+            '',
+            '#define NL_ATLAS_FIRST %d' % first,
+            '#define NL_ATLAS_WORDS %d' % len(words),
+            '',
+            '#if BGFX_SHADER_LANGUAGE_GLSL || BGFX_SHADER_LANGUAGE_SPIRV || BGFX_SHADER_LANGUAGE_METAL',
+            'const int NL_ATLAS_TABLE[%d] = int[%d](' % (len(words), len(words)),
+            '#else',
+            '// HLSL (and C++ of the CPU bench) have no array constructors',
+            'static const int NL_ATLAS_TABLE[%d] = {' % len(words),
+            '#endif',
+            ',\n'.join(rows),
+            '#if BGFX_SHADER_LANGUAGE_GLSL || BGFX_SHADER_LANGUAGE_SPIRV || BGFX_SHADER_LANGUAGE_METAL',
+            ');',
+            '#else',
+            '};',
+            '#endif',
+            '',
+            '#endif',
+            '',
+        ]
+        with open(args.out, 'w') as f:
+            f.write('\n'.join(lines))
+        print('wrote %s' % args.out)
+
+    return 0
+
+
+if __name__ == '__main__':
+    sys.exit(main())
@@ -0,0 +1,391 @@
+#!/usr/bin/env python3
+"""Fit exposure, tonemap and contrast of colorCorrection into one curve.
+
+Resolves config.h once per subpack option (the option defined like pack.sh
+does on line 3) and fits the per channel part of colorCorrection (tonemap.h)
+    F(x) = pow(T(NL_EXPOSURE*x), NL_CONSTRAST)
+with a polynomial of u = 2*s/s_max - 1, s = x/(x + k). s maps [0, inf) to
+[0, 1) and u keeps the coefficients small enough for fp16 (NL_MEDIUMP). The
+shader then needs one division and a few multiply-adds per channel instead
+of the tonemap and the pow. Tonemaps without an upper bound (3 and 9) have
+no finite F at s = 1, their input is clamped to [0, XMAX] and fitted there.
+Saturation and tint mix channels and stay as they are. ACES (4) and the PBR
+tonemap (11) are not per channel and are not fitted.
+
+The coefficients minimize the largest error (Lawson weighted least squares
+on a Chebyshev basis) and the degree is the lowest one within the tolerance.
+Errors are in 8-bit steps of the output: "curve" is the largest error of F
+alone, "chain" the bound after the saturation mix and tint,
+(|S| + |1 - S|)*max(tint). Errors are not clamped to the render target as
+the saturation mix carries channels above 1 into the others. Both are
+measured on a dense grid over all inputs (up to XMAX when clamped).
+
+Subpacks that resolve to the same curve as the default share its block.
+
+The header carries a stamp of everything it was fitted from: the resolved
+constants of every subpack, the fit options and this tool. With -o, an
+existing header with the same stamp is left as it is ("up to date"), so
+tools/generate.sh runs the tool before every build instead of comparing
+file times, which a git checkout does not keep. -c only checks the stamp
+and fails when the header is stale.
+"""
+
+import argparse
+import hashlib
+import math
+import os
+import re
+import sys
+
+HEADER_GUARD = 'COLOR_FIT_H'
+
+# per channel tonemaps of colorCorrection, by NL_TONEMAP_TYPE
+def hejl(x):
+    # 0/0 at x = 0 in the shader, use the limit from above
+    x = max(x, 1e-9)
+    return max(0.0, (x*(x + 0.0245786 - 0.000090537))/(x*(0.983729*x + 0.4329510 + 0.238081)))
+
+TONEMAPS = {
+    1: ('Exponential', lambda x: 1.0 - math.exp(-x*0.8)),
+    2: ('Simple Reinhard', lambda x: x/(1.0 + x)),
+    3: ('Extended Reinhard', lambda x: x*(1.0 + x*0.063)/(1.0 + x)),
+    5: ('Filmic', lambda x: (x*(2.51*x + 0.03))/(x*(2.43*x + 0.59) + 0.14)),
+    6: ('Hejl 2015', hejl),
+    7: ('Hable', lambda x: (x*(x*0.6 + 0.5))/(x*(x*0.3 + 0.6) + 0.1)),
+    8: ('Uncharted 2', lambda x: (x*(x*0.426 + 0.55))/(x*(x*0.3 + 0.45) + 0.05)),
+    9: ('Reinhard Extended (modified)', lambda x: x*(1.0 + x*0.2)/(1.0 + x)),
+    10: ('Unreal Engine', lambda x: x/(x + 0.155)*1.019),
+}
+NOT_SEPARABLE = {4: 'ACES', 11: 'Custom PBR & Deferred Rendering'}
+
+
+def resolve_config(path, option):
+    """Macro values of config.h with option defined, last #define wins."""
+    with open(path) as f:
+        text = f.read()
+    text = re.sub(r'/\*.*?\*/', lambda m: '\n'*m.group(0).count('\n'), text, flags=re.S)
+
+    macros = {option: ''}
+    stack = []  # (active, parent active)
+    for line in text.split('\n'):
+        line = line.split('//')[0].strip()
+        m = re.match(r'#\s*(\w+)\s*(\w*)\s*(.*)', line)
+        if not m:
+            continue
+        directive, name, value = m.groups()
+        active = all(s[0] for s in stack)
+        if directive in ('ifdef', 'ifndef'):
+            stack.append([active and ((name in macros) == (directive == 'ifdef')), active])
+        elif directive == 'else':
+            stack[-1][0] = stack[-1][1] and not stack[-1][0]
+        elif directive == 'endif':
+            stack.pop()
+        elif not active:
+            continue
+        elif directive == 'define':
+            macros[name] = value.strip()
+        elif directive == 'undef':
+            macros.pop(name, None)
+        elif directive in ('if', 'elif'):
+            sys.exit('Error: #%s is not supported in %s' % (directive, path))
+    return macros
+
+
+def parse_vec3(value):
+    m = re.match(r'vec3(?:_splat)?\((.*)\)$', value.replace(' ', ''))
+    if not m:
+        return [float(value)]*3
+    parts = [float(v) for v in m.group(1).split(',')]
+    return parts*3 if len(parts) == 1 else parts
+
+
+class Setup:
+    """colorCorrection constants of one resolved config."""
+
+    def __init__(self, macros):
+        self.tonemap = int(macros.get('NL_TONEMAP_TYPE', '0'))
+        self.exposure = float(macros['NL_EXPOSURE']) if 'NL_EXPOSURE' in macros else None
+        self.contrast = float(macros.get('NL_CONSTRAST', '1.0'))
+        self.saturation = float(macros['NL_SATURATION']) if 'NL_SATURATION' in macros else None
+        self.tint = parse_vec3(macros['NL_TINT']) if 'NL_TINT' in macros else None
+        self.xmax = None
+
+    def key(self):
+        return (self.tonemap, self.exposure, self.contrast, self.saturation,
+                tuple(self.tint) if self.tint else None)
+
+    def curve(self, x):
+        x = min(x, 1e12)
+        y = TONEMAPS[self.tonemap][1]((self.exposure or 1.0)*x)
+        return y**self.contrast if y > 0.0 else 0.0
+
+    def chain_gain(self):
+        """Largest factor an error of one channel can grow by after saturation and tint."""
+        s = 1.0 if self.saturation is None else self.saturation
+        return (abs(s) + abs(1.0 - s))*(max(self.tint) if self.tint else 1.0)
+
+    def describe(self):
+        d = 'NL_TONEMAP_TYPE %d' % self.tonemap
+        if self.exposure is not None:
+            d += ', NL_EXPOSURE %g' % self.exposure
+        d += ', NL_CONSTRAST %g' % self.contrast
+        if self.saturation is not None:
+            d += ', NL_SATURATION %g' % self.saturation
+        return d
+
+
+def solve(a, b):
+    """Gaussian elimination with partial pivoting, a is n x n."""
+    n = len(b)
+    m = [a[i][:] + [b[i]] for i in range(n)]
+    for c in range(n):
+        p = max(range(c, n), key=lambda r: abs(m[r][c]))
+        m[c], m[p] = m[p], m[c]
+        for r in range(c + 1, n):
+            f = m[r][c]/m[c][c]
+            for j in range(c, n + 1):
+                m[r][j] -= f*m[c][j]
+    x = [0.0]*n
+    for i in reversed(range(n)):
+        x[i] = (m[i][n] - sum(m[i][j]*x[j] for j in range(i + 1, n)))/m[i][i]
+    return x
+
+
+def chebyshev(v, degree):
+    u = 2.0*v - 1.0
+    t = [1.0, u]
+    while len(t) <= degree:
+        t.append(2.0*u*t[-1] - t[-2])
+    return t[:degree + 1]
+
+
+def s_max(setup, k):
+    return 1.0 if setup.xmax is None else setup.xmax/(setup.xmax + k)
+
+
+def fit(setup, k, degree, samples=301, iterations=30):
+    """Minimax polynomial of v = s/s_max, returns (error, chebyshev coefficients)."""
+    smax = s_max(setup, k)
+    vs = [i/(samples - 1) for i in range(samples)]
+    ys = [setup.curve(k*v*smax/(1.0 - v*smax) if v*smax < 1.0 else 1e12) for v in vs]
+    basis = [chebyshev(v, degree) for v in vs]
+    n = degree + 1
+
+    w = [1.0/samples]*samples
+    best = (float('inf'), None)
+    for _ in range(iterations):
+        a = [[sum(w[i]*basis[i][p]*basis[i][q] for i in range(samples)) for q in range(n)] for p in range(n)]
+        b = [sum(w[i]*basis[i][p]*ys[i] for i in range(samples)) for p in range(n)]
+        c = solve(a, b)
+        e = [sum(c[p]*basis[i][p] for p in range(n)) - ys[i] for i in range(samples)]
+        err = max(abs(v) for v in e)
+        if err < best[0]:
+            best = (err, c)
+        w = [w[i]*abs(e[i]) + 1e-12 for i in range(samples)]
+        total = sum(w)
+        w = [v/total for v in w]
+    return best
+
+
+def to_monomial(cheb):
+    """Chebyshev coefficients to powers of u. Small on [-1, 1], so fp16 keeps them."""
+    polys = [[1.0], [0.0, 1.0]]
+    while len(polys) < len(cheb):
+        a, b = polys[-1], polys[-2]
+        p = [0.0] + [2.0*v for v in a]
+        for i, v in enumerate(b):
+            p[i] -= v
+        polys.append(p)
+    out = [0.0]*len(cheb)
+    for c, p in zip(cheb, polys):
+        for i, v in enumerate(p):
+            out[i] += c*v
+    return out
+
+
+def evaluate(coefs, k, scale, xmax, x):
+    x = max(x, 0.0) if xmax is None else min(max(x, 0.0), xmax)
+    u = scale*x/(x + k) - 1.0
+    y = 0.0
+    for c in reversed(coefs):
+        y = y*u + c
+    return y
+
+
+def measure(setup, coefs, k, scale, points=20000):
+    """Largest error on a grid of t = x/(x + 1), up to x = 1e12 or xmax."""
+    tmax = 1.0 if setup.xmax is None else setup.xmax/(setup.xmax + 1.0)
+    err = 0.0
+    for i in range(points + 1):
+        t = tmax*i/points
+        x = t/(1.0 - t) if t < 1.0 else 1e12
+        err = max(err, abs(evaluate(coefs, k, scale, setup.xmax, x) - setup.curve(x)))
+    return 255.0*err
+
+
+def best_fit(setup, degree):
+    """Search the s = x/(x + k) scale, coarse grid then golden section on log k."""
+    grid = [0.05*1.4**i for i in range(20)]
+    errs = [fit(setup, k, degree)[0] for k in grid]
+    i = errs.index(min(errs))
+    lo = math.log(grid[max(i - 1, 0)])
+    hi = math.log(grid[min(i + 1, len(grid) - 1)])
+    g = (math.sqrt(5.0) - 1.0)/2.0
+    for _ in range(10):
+        a, b = hi - g*(hi - lo), lo + g*(hi - lo)
+        if fit(setup, math.exp(a), degree)[0] < fit(setup, math.exp(b), degree)[0]:
+            hi = b
+        else:
+            lo = a
+    candidates = [grid[i], math.exp(0.5*(lo + hi))]
+    k = min(candidates, key=lambda c: fit(setup, c, degree)[0])
+    # round k to the printed precision before the final fit
+    k = float('%.4g' % k)
+    cheb = fit(setup, k, degree)[1]
+    scale = float('%.7g' % (2.0/s_max(setup, k)))
+    coefs = [float('%.7g' % c) for c in to_monomial(cheb)]
+    return k, scale, coefs, measure(setup, coefs, k, scale)
+
+
+def glsl_float(v):
+    s = '%.7g' % v
+    if 'e' in s:
+        s = '%.9f' % v
+    return s if '.' in s else s + '.0'
+
+
+def block(setup, k, scale, coefs, err):
+    horner = glsl_float(coefs[-1])
+    for c in reversed(coefs[:-1]):
+        horner = '%s + u*(%s)' % (glsl_float(c), horner)
+    return '\n'.join([
+        '// %s' % setup.describe(),
+        '// %s, degree %d: %.2f steps curve, %.2f steps chain' % (
+            TONEMAPS[setup.tonemap][0], len(coefs) - 1, err, err*setup.chain_gain()),
+        '#define NL_COLOR_FIT',
+        'vec3 nlColorFit(vec3 col) {',
+        '  vec3 s = max(col, 0.0);' if setup.xmax is None else
+        '  vec3 s = clamp(col, 0.0, %s);' % glsl_float(setup.xmax),
+        '  vec3 u = %s*s/(s + %s) - 1.0;' % (glsl_float(scale), glsl_float(k)),
+        '  return %s;' % horner,
+        '}',
+    ])
+
+
+def fit_stamp(setups, args):
+    """Hash of the resolved constants, the fit options and this tool."""
+    h = hashlib.sha256()
+    for option, setup in setups:
+        h.update(repr((option, setup.key())).encode())
+    h.update(repr((args.tolerance, args.xmax, args.max_degree)).encode())
+    with open(os.path.abspath(__file__), 'rb') as f:
+        h.update(f.read())
+    return h.hexdigest()[:16]
+
+
+def read_stamp(path):
+    if not os.path.isfile(path):
+        return None
+    with open(path) as f:
+        m = re.search(r'^// stamp (\w+)$', f.read(), flags=re.M)
+    return m.group(1) if m else None
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.split('\n')[0])
+    parser.add_argument('config', help='config.h (eg. include/newb/config.h)')
+    parser.add_argument('options', nargs='*', help='subpack options (SUBPACK_OPTIONS of pack_config.sh)')
+    parser.add_argument('-o', dest='out', help='header to write (eg. <include copy>/newb/functions/color_fit.h, see tools/generate.sh)')
+    parser.add_argument('-t', dest='tolerance', type=float, default=0.5,
+                        help='allowed chain error in 8-bit steps (default 0.5)')
+    parser.add_argument('-x', dest='xmax', type=float, default=16.0,
+                        help='input clamp of unbounded tonemaps (default 16)')
+    parser.add_argument('-d', dest='max_degree', type=int, default=6, help='highest degree tried (default 6)')
+    parser.add_argument('-c', dest='check', action='store_true',
+                        help='only check that the -o header matches config.h, fail if it does not')
+    args = parser.parse_args()
+
+    if not os.path.isfile(args.config):
+        sys.exit('Error: %s not found' % args.config)
+    if args.check and not args.out:
+        sys.exit('Error: -c needs the header to check (-o)')
+
+    options = ['default'] + [o for o in args.options if o.upper() != 'DEFAULT']
+    setups = [(option, Setup(resolve_config(args.config, option))) for option in options]
+    stamp = fit_stamp(setups, args)
+    current = read_stamp(args.out) if args.out else None
+    if args.check:
+        if current != stamp:
+            print('Error: %s is stale (stamp %s, config %s), run tools/color_fit.py' % (args.out, current, stamp))
+            return 2
+        print('%s is up to date' % args.out)
+        return 0
+    if current == stamp:
+        print('%s is up to date' % args.out)
+        return 0
+
+    # default first, subpacks resolving to the same constants share its block
+    variants = []
+    seen = {}
+    for option, setup in setups:
+        if setup.tonemap in TONEMAPS and setup.curve(1e12) > 1e3:
+            setup.xmax = args.xmax
+        if setup.key() in seen:
+            print('%-12s same as %s' % (option, seen[setup.key()]))
+            continue
+        seen[setup.key()] = option
+        variants.append((option, setup))
+
+    print('%-12s %-34s %6s %8s %8s %8s' % ('subpack', 'tonemap', 'degree', 'k', 'curve', 'chain'))
+    blocks = []
+    for option, setup in variants:
+        if setup.tonemap in NOT_SEPARABLE:
+            text = '// %s\n// %s tonemap mixes channels, not fitted' % (setup.describe(), NOT_SEPARABLE[setup.tonemap])
+            print('%-12s %-34s %6s' % (option, NOT_SEPARABLE[setup.tonemap], '-'))
+        elif setup.tonemap not in TONEMAPS:
+            sys.exit('Error: unknown NL_TONEMAP_TYPE %d for %s' % (setup.tonemap, option))
+        else:
+            for degree in range(2, args.max_degree + 1):
+                k, scale, coefs, err = best_fit(setup, degree)
+                if err*setup.chain_gain() <= args.tolerance:
+                    break
+            chain = err*setup.chain_gain()
+            print('%-12s %-34s %6d %8.4g %8.2f %8.2f' % (option, TONEMAPS[setup.tonemap][0], degree, k, err, chain))
+            if chain <= args.tolerance:
+                text = block(setup, k, scale, coefs, err)
+            else:
+                text = '// %s\n// best fit %.2f steps, above %.2f, not fitted' % (setup.describe(), chain, args.tolerance)
+        blocks.append((option, text))
+
+    if args.out:
+        lines = [
+            '#ifndef %s' % HEADER_GUARD,
+            '#define %s' % HEADER_GUARD,
+            '',
+            '/* Generated by tools/color_fit.py from config.h, do not edit.',
+            ' * Exposure, tonemap and contrast of colorCorrection as one curve of',
+            ' * x/(x + k) per subpack, errors in 8-bit steps (see the tool).',
+            ' */',
+            '// stamp %s' % stamp,
+            '',
+        ]
+        default = blocks[0][1]
+        for i, (option, text) in enumerate(blocks[1:]):
+            lines.append('#%s defined(%s)' % ('if' if i == 0 else 'elif', option))
+            lines.append(text)
+        if len(blocks) > 1:
+            lines.append('#else')
+            lines.append(default)
+            lines.append('#endif')
+        else:
+            lines.append(default)
+        lines += ['', '#endif', '']
+        with open(args.out, 'w') as f:
+            f.write('\n'.join(lines))
+        print('wrote %s' % args.out)
+
+    return 0
+
+
+if __name__ == '__main__':
+    sys.exit(main())
@@ -0,0 +1,262 @@
+/* Per-function microbenchmark for include/newb/functions.
+ *
+ * usage: bench [-f filter] [-e state] [-o results.txt] [-b baseline.txt] [-m min_ms]
+ *   -f  only run functions whose name contains filter
+ *   -e  only use inputs of one scene state (day, dusk, night, rain, nether, end, underwater)
+ *   -o  write "name ns/call" lines for use as a later baseline
+ *   -b  print the delta against a previous -o file
+ *   -m  minimum measuring time per function (default 200 ms)
+ */
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <map>
+#include <string>
+#include <vector>
+
+#include "scene.h"
+
+using namespace nl;
+
+static const int kSampleCount = 1024;
+static const int kTrials = 5;
+
+static double gMinSeconds = 0.2;
+static volatile float gSink;
+
+// best-of-trials ns per call over the whole sample set
+template <class F>
+static double measure(const std::vector<Sample> &samples, F fn) {
+  using clock = std::chrono::steady_clock;
+  double best = 1e30;
+
+  for (int trial = 0; trial < kTrials; trial++) {
+    long calls = 0;
+    float sink = 0.0f;
+    auto start = clock::now();
+    double elapsed;
+    do {
+      for (const Sample &s : samples) {
+        sink += fn(s);
+      }
+      calls += long(samples.size());
+      elapsed = std::chrono::duration<double>(clock::now() - start).count();
+    } while (elapsed < gMinSeconds/kTrials);
+    gSink = sink;
+
+    double ns = 1e9*elapsed/double(calls);
+    if (ns < best) {
+      best = ns;
+    }
+  }
+  return best;
+}
+
+struct Result {
+  std::string name;
+  double ns;
+};
+
+static std::map<std::string, double> readResults(const char *path) {
+  std::map<std::string, double> results;
+  FILE *f = fopen(path, "r");
+  if (f == nullptr) {
+    fprintf(stderr, "Error: cannot read %s\n", path);
+    exit(1);
+  }
+  char name[128];
+  double ns;
+  while (fscanf(f, "%127s %lf", name, &ns) == 2) {
+    results[name] = ns;
+  }
+  fclose(f);
+  return results;
+}
+
+int main(int argc, char **argv) {
+  const char *filter = "";
+  const char *state = nullptr;
+  const char *outPath = nullptr;
+  const char *basePath = nullptr;
+
+  for (int i = 1; i < argc; i++) {
+    if (i + 1 < argc && strcmp(argv[i], "-f") == 0) {
+      filter = argv[++i];
+    } else if (i + 1 < argc && strcmp(argv[i], "-e") == 0) {
+      state = argv[++i];
+    } else if (i + 1 < argc && strcmp(argv[i], "-o") == 0) {
+      outPath = argv[++i];
+    } else if (i + 1 < argc && strcmp(argv[i], "-b") == 0) {
+      basePath = argv[++i];
+    } else if (i + 1 < argc && strcmp(argv[i], "-m") == 0) {
+      gMinSeconds = atof(argv[++i])*0.001;
+    } else {
+      fprintf(stderr, "Invalid option: %s\n", argv[i]);
+      return 1;
+    }
+  }
+
+  const std::vector<Sample> samples = makeSamples(kSampleCount, 1u, state);
+  if (samples.empty()) {
+    fprintf(stderr, "Error: unknown scene state %s\n", state);
+    return 1;
+  }
+  std::vector<Result> results;
+
+  auto run = [&](const char *name, auto fn) {
+    if (strstr(name, filter) != nullptr) {
+      results.push_back({name, measure(samples, fn)});
+    }
+  };
+
+  // clouds
+  run("renderClouds", [](const Sample &s) {
+    vec3 vDir = normalize(vec3(s.viewDir.x, 0.05f + abs(s.viewDir.y), s.viewDir.z));
+    vec3 vPos = vec3(s.worldPos.x, 2.0f*s.worldPos.y - 10.0f, s.worldPos.z);
+    // clouds are drawn up to ~4x farther than terrain
+    float fade = clamp(2.0f - 0.0088f*s.camDist, 0.0f, 1.0f);
+    return renderClouds(vDir, vPos, s.rainFactor, s.t, s.horizonEdgeCol, s.zenithCol, fade).a;
+  });
+  run("renderCloudsRefl", [](const Sample &s) {
+    return renderCloudsRefl(s.worldPos.xz, s.rainFactor, s.t, s.horizonEdgeCol, s.zenithCol).a;
+  });
+  run("cloudDf", [](const Sample &s) {
+    vec3 pos = vec3(NL_CLOUD2_SCALE*s.worldPos.x, s.bPos.y, NL_CLOUD2_SCALE*s.worldPos.z);
+    return cloudDf(pos, s.rainFactor);
+  });
+
+  // noise
+  run("snoise", [](const Sample &s) {
+    return snoise(s.worldPos.xz);
+  });
+  run("noise", [](const Sample &s) {
+    return noise(s.worldPos);
+  });
+
+  // sky
+  run("nlRenderSky", [](const Sample &s) {
+    return nlRenderSky(s.horizonEdgeCol, s.horizonCol, s.zenithCol, -s.viewDir, s.fogColor, s.t, s.rainFactor, s.end, s.underWater, s.nether).g;
+  });
+  run("nlFallingStars", [](const Sample &s) {
+    // as in Sky.fragment.sc, sky positions span about 250 cells
+    float mask = (1.0f - s.rainFactor)*max(1.0f - 3.0f*max(s.fogColor.b, s.fogColor.g), 0.0f);
+    if (mask > 0.0f) {
+      return mask*nlFallingStars(2.6f*s.worldPos.xz, s.t).b;
+    }
+    return 0.0f;
+  });
+
+  // terrain
+  run("nlLighting", [](const Sample &s) {
+    vec3 torchColor;
+    vec3 light = nlLighting(
+      s.worldPos, torchColor, s.color.rgb, s.fogColor, s.rainFactor, s.uv1, s.lit, false,
+      s.horizonCol, s.zenithCol, s.color.g, s.end, s.nether, s.underWater, s.t, 0.0f
+    );
+    return light.g + torchColor.r;
+  });
+  run("nlWater", [](const Sample &s) {
+    vec3 wPos = s.worldPos;
+    vec4 color = s.color;
+    vec4 refl = nlWater(
+      wPos, color, s.color, s.viewDir, vec3_splat(1.0f), s.cPos, s.tiledCpos, s.bPos.y, s.fogColor,
+      s.horizonCol, s.horizonEdgeCol, s.zenithCol, s.lit, s.t, s.camDist, s.rainFactor,
+      vec3(1.0f, 0.52f, 0.18f), s.end, s.nether, s.underWater
+    );
+    return refl.g + refl.a + color.a + wPos.y;
+  });
+  run("nlRefl", [](const Sample &s) {
+    vec4 color = s.color;
+    vec4 mistColor = vec4(s.horizonCol, 0.5f);
+    vec4 refl = nlRefl(
+      color, mistColor, s.lit, s.uv1, s.tiledCpos, nlReflShade(s.color.g), s.camDist, s.worldPos, s.viewDir, vec3(1.0f, 0.52f, 0.18f),
+      s.horizonEdgeCol, s.horizonCol, s.zenithCol, s.fogColor, s.rainFactor, s.fogControl.z, s.t, s.worldPos,
+      s.underWater, s.end, s.nether
+    );
+    return refl.g + refl.a + color.g + mistColor.a;
+  });
+  run("nlRenderGodRayIntensity", [](const Sample &s) {
+    return nlRenderGodRayIntensity(s.cPos, s.worldPos, s.t, s.uv1, s.relativeDist, s.fogColor);
+  });
+  run("terrainVertex", [](const Sample &s) {
+    // RenderChunk.vertex.sc with vertices spread over the whole render distance,
+    // tools/bench_sync.py checks that the calls still match the shader
+    vec3 worldPos = 2.0f*s.worldPos;
+    float camDist = 2.0f*s.camDist;
+    float relativeDist = camDist/s.fogControl.z;
+    vec2 lod = nlLod(relativeDist);
+
+    vec3 torchColor;
+    vec3 light = nlLighting(
+      worldPos, torchColor, s.color.rgb, s.fogColor, s.rainFactor, s.uv1, s.lit, false,
+      s.horizonCol, s.zenithCol, s.color.g, s.end, s.nether, s.underWater, s.t, lod.x
+    );
+
+    vec4 fogColor;
+    fogColor.a = nlRenderFogFade(relativeDist, s.fogColor, s.fogControl.xy);
+    if (lod.y < 1.0) {
+      fogColor.a = mix(fogColor.a, 1.0f, (1.0f - lod.y)*NL_GODRAY*nlRenderGodRayIntensity(s.cPos, worldPos, s.t, s.uv1, relativeDist, s.fogColor));
+    }
+    if (s.nether) {
+      fogColor.rgb = colorCorrectionInv(s.fogColor);
+      fogColor.rgb = mix(fogColor.rgb, vec3(0.8f, 0.2f, 0.12f)*1.5f, s.lit.x*(1.67f - fogColor.a*1.67f));
+    } else if (lod.y < 1.0) {
+      fogColor.rgb = nlRenderSky(s.horizonEdgeCol, s.horizonCol, s.zenithCol, s.viewDir, s.fogColor, s.t, s.rainFactor, s.end, s.underWater, s.nether);
+      if (lod.y > 0.0) {
+        fogColor.rgb = mix(fogColor.rgb, nlRenderSkyFar(s.horizonEdgeCol, s.horizonCol, s.zenithCol, s.viewDir, s.t, s.end, s.underWater), lod.y);
+      }
+    } else {
+      fogColor.rgb = nlRenderSkyFar(s.horizonEdgeCol, s.horizonCol, s.zenithCol, s.viewDir, s.t, s.end, s.underWater);
+    }
+
+    vec4 color = s.color;
+    vec4 refl = nlRefl(
+      color, fogColor, s.lit, s.uv1, s.tiledCpos, nlReflShade(s.color.g), camDist, worldPos, s.viewDir, torchColor,
+      s.horizonEdgeCol, s.horizonCol, s.zenithCol, s.fogColor, s.rainFactor, s.fogControl.z, s.t, worldPos,
+      s.underWater, s.end, s.nether
+    );
+
+    // clip position, worldPos stands in for the u_viewProj transform
+    vec3 pos = worldPos;
+    if (s.underWater) {
+      nlUnderwaterLighting(light, pos, s.lit, s.uv1, s.tiledCpos, s.cPos, s.t, s.horizonEdgeCol, lod.x);
+    }
+    return light.g + fogColor.g + fogColor.a + refl.g + refl.a + color.g + pos.x;
+  });
+
+  // every fragment
+  run("colorCorrection", [](const Sample &s) {
+    return colorCorrection(4.0f*s.color.rgb).g;
+  });
+
+  std::map<std::string, double> baseline;
+  if (basePath != nullptr) {
+    baseline = readResults(basePath);
+  }
+
+  printf("%-28s %10s %9s\n", "function", "ns/call", "delta");
+  for (const Result &r : results) {
+    printf("%-28s %10.2f", r.name.c_str(), r.ns);
+    auto base = baseline.find(r.name);
+    if (base != baseline.end() && base->second > 0.0) {
+      printf(" %+8.1f%%", 100.0*(r.ns - base->second)/base->second);
+    }
+    printf("\n");
+  }
+
+  if (outPath != nullptr) {
+    FILE *f = fopen(outPath, "w");
+    if (f == nullptr) {
+      fprintf(stderr, "Error: cannot write %s\n", outPath);
+      return 1;
+    }
+    for (const Result &r : results) {
+      fprintf(f, "%s %.3f\n", r.name.c_str(), r.ns);
+    }
+    fclose(f);
+  }
+
+  return 0;
+}
@@ -0,0 +1,382 @@
+#ifndef NL_CPU_GLSL_H
+#define NL_CPU_GLSL_H
+
+/* GLSL/bgfx compatibility shim for compiling include/newb as C++.
+ * Everything lives in namespace nl so unqualified calls inside the
+ * shader headers resolve to these overloads and not to <cmath>.
+ * out/inout parameter qualifiers are rewritten to references by bench.sh
+ * before the headers are included. Include standard headers before this.
+ */
+
+#include <cmath>
+
+#define highp
+#define mediump
+#define lowp
+// a shader may declare uniforms that only some variants read
+#define uniform [[maybe_unused]] static
+
+namespace nl {
+
+struct vec2;
+struct vec3;
+struct vec4;
+
+// swizzle proxy: aliases the storage of its parent vector
+template <class V, int N, int... I>
+struct swizzle {
+  float e[N];
+
+  operator V() const { return V(e[I]...); }
+
+  swizzle &operator=(const V &v) {
+    int k = 0;
+    ((e[I] = v[k++]), ...);
+    return *this;
+  }
+  swizzle &operator=(const swizzle &s) { return *this = V(s); }
+
+  swizzle &operator+=(const V &v) { return *this = V(*this) + v; }
+  swizzle &operator-=(const V &v) { return *this = V(*this) - v; }
+  swizzle &operator*=(const V &v) { return *this = V(*this) * v; }
+  swizzle &operator/=(const V &v) { return *this = V(*this) / v; }
+  swizzle &operator+=(float s) { return *this = V(*this) + s; }
+  swizzle &operator-=(float s) { return *this = V(*this) - s; }
+  swizzle &operator*=(float s) { return *this = V(*this) * s; }
+  swizzle &operator/=(float s) { return *this = V(*this) / s; }
+};
+
+#define NL_CAT_(a, b) a##b
+#define NL_CAT(a, b) NL_CAT_(a, b)
+
+// component sets, one copy per nesting level (macros can't recurse)
+#define NL_XY_1(M, ...) M(x, 0, __VA_ARGS__) M(y, 1, __VA_ARGS__)
+#define NL_XY_2(M, ...) M(x, 0, __VA_ARGS__) M(y, 1, __VA_ARGS__)
+#define NL_XY_3(M, ...) M(x, 0, __VA_ARGS__) M(y, 1, __VA_ARGS__)
+#define NL_XY_4(M, ...) M(x, 0, __VA_ARGS__) M(y, 1, __VA_ARGS__)
+#define NL_RG_1(M, ...) M(r, 0, __VA_ARGS__) M(g, 1, __VA_ARGS__)
+#define NL_RG_2(M, ...) M(r, 0, __VA_ARGS__) M(g, 1, __VA_ARGS__)
+#define NL_RG_3(M, ...) M(r, 0, __VA_ARGS__) M(g, 1, __VA_ARGS__)
+#define NL_RG_4(M, ...) M(r, 0, __VA_ARGS__) M(g, 1, __VA_ARGS__)
+#define NL_XYZ_1(M, ...) NL_XY_1(M, __VA_ARGS__) M(z, 2, __VA_ARGS__)
+#define NL_XYZ_2(M, ...) NL_XY_2(M, __VA_ARGS__) M(z, 2, __VA_ARGS__)
+#define NL_XYZ_3(M, ...) NL_XY_3(M, __VA_ARGS__) M(z, 2, __VA_ARGS__)
+#define NL_XYZ_4(M, ...) NL_XY_4(M, __VA_ARGS__) M(z, 2, __VA_ARGS__)
+#define NL_RGB_1(M, ...) NL_RG_1(M, __VA_ARGS__) M(b, 2, __VA_ARGS__)
+#define NL_RGB_2(M, ...) NL_RG_2(M, __VA_ARGS__) M(b, 2, __VA_ARGS__)
+#define NL_RGB_3(M, ...) NL_RG_3(M, __VA_ARGS__) M(b, 2, __VA_ARGS__)
+#define NL_RGB_4(M, ...) NL_RG_4(M, __VA_ARGS__) M(b, 2, __VA_ARGS__)
+#define NL_XYZW_1(M, ...) NL_XYZ_1(M, __VA_ARGS__) M(w, 3, __VA_ARGS__)
+#define NL_XYZW_2(M, ...) NL_XYZ_2(M, __VA_ARGS__) M(w, 3, __VA_ARGS__)
+#define NL_XYZW_3(M, ...) NL_XYZ_3(M, __VA_ARGS__) M(w, 3, __VA_ARGS__)
+#define NL_XYZW_4(M, ...) NL_XYZ_4(M, __VA_ARGS__) M(w, 3, __VA_ARGS__)
+#define NL_RGBA_1(M, ...) NL_RGB_1(M, __VA_ARGS__) M(a, 3, __VA_ARGS__)
+#define NL_RGBA_2(M, ...) NL_RGB_2(M, __VA_ARGS__) M(a, 3, __VA_ARGS__)
+#define NL_RGBA_3(M, ...) NL_RGB_3(M, __VA_ARGS__) M(a, 3, __VA_ARGS__)
+#define NL_RGBA_4(M, ...) NL_RGB_4(M, __VA_ARGS__) M(a, 3, __VA_ARGS__)
+
+#define NL_SW2_B(b, ib, N, S, a, ia) swizzle<vec2, N, ia, ib> a##b;
+#define NL_SW2_A(a, ia, N, S) NL_CAT(S, _2)(NL_SW2_B, N, S, a, ia)
+
+#define NL_SW3_C(c, ic, N, S, a, ia, b, ib) swizzle<vec3, N, ia, ib, ic> a##b##c;
+#define NL_SW3_B(b, ib, N, S, a, ia) NL_CAT(S, _3)(NL_SW3_C, N, S, a, ia, b, ib)
+#define NL_SW3_A(a, ia, N, S) NL_CAT(S, _2)(NL_SW3_B, N, S, a, ia)
+
+#define NL_SW4_D(d, id, N, S, a, ia, b, ib, c, ic) swizzle<vec4, N, ia, ib, ic, id> a##b##c##d;
+#define NL_SW4_C(c, ic, N, S, a, ia, b, ib) NL_CAT(S, _4)(NL_SW4_D, N, S, a, ia, b, ib, c, ic)
+#define NL_SW4_B(b, ib, N, S, a, ia) NL_CAT(S, _3)(NL_SW4_C, N, S, a, ia, b, ib)
+#define NL_SW4_A(a, ia, N, S) NL_CAT(S, _2)(NL_SW4_B, N, S, a, ia)
+
+#define NL_SWIZZLES(N, S) \
+  NL_CAT(S, _1)(NL_SW2_A, N, S) \
+  NL_CAT(S, _1)(NL_SW3_A, N, S) \
+  NL_CAT(S, _1)(NL_SW4_A, N, S)
+
+struct vec2 {
+  union {
+    float e[2];
+    struct { float x, y; };
+    struct { float r, g; };
+    NL_SWIZZLES(2, NL_XY)
+    NL_SWIZZLES(2, NL_RG)
+  };
+
+  vec2() : e{0.0f, 0.0f} {}
+  explicit vec2(float s) : e{s, s} {}
+  vec2(float a, float b) : e{a, b} {}
+  explicit vec2(const vec3 &v);
+  explicit vec2(const vec4 &v);
+  vec2(const vec2 &v) : e{v.e[0], v.e[1]} {}
+  vec2 &operator=(const vec2 &v) { e[0] = v.e[0]; e[1] = v.e[1]; return *this; }
+
+  float &operator[](int i) { return e[i]; }
+  float operator[](int i) const { return e[i]; }
+};
+
+struct vec3 {
+  union {
+    float e[3];
+    struct { float x, y, z; };
+    struct { float r, g, b; };
+    NL_SWIZZLES(3, NL_XYZ)
+    NL_SWIZZLES(3, NL_RGB)
+  };
+
+  vec3() : e{0.0f, 0.0f, 0.0f} {}
+  explicit vec3(float s) : e{s, s, s} {}
+  vec3(float a, float b, float c) : e{a, b, c} {}
+  vec3(const vec2 &v, float c) : e{v.e[0], v.e[1], c} {}
+  vec3(float a, const vec2 &v) : e{a, v.e[0], v.e[1]} {}
+  explicit vec3(const vec4 &v);
+  vec3(const vec3 &v) : e{v.e[0], v.e[1], v.e[2]} {}
+  vec3 &operator=(const vec3 &v) { e[0] = v.e[0]; e[1] = v.e[1]; e[2] = v.e[2]; return *this; }
+
+  float &operator[](int i) { return e[i]; }
+  float operator[](int i) const { return e[i]; }
+};
+
+struct vec4 {
+  union {
+    float e[4];
+    struct { float x, y, z, w; };
+    struct { float r, g, b, a; };
+    NL_SWIZZLES(4, NL_XYZW)
+    NL_SWIZZLES(4, NL_RGBA)
+  };
+
+  vec4() : e{0.0f, 0.0f, 0.0f, 0.0f} {}
+  explicit vec4(float s) : e{s, s, s, s} {}
+  vec4(float a, float b, float c, float d) : e{a, b, c, d} {}
+  vec4(const vec2 &v, float c, float d) : e{v.e[0], v.e[1], c, d} {}
+  vec4(float a, const vec2 &v, float d) : e{a, v.e[0], v.e[1], d} {}
+  vec4(float a, float b, const vec2 &v) : e{a, b, v.e[0], v.e[1]} {}
+  vec4(const vec2 &u, const vec2 &v) : e{u.e[0], u.e[1], v.e[0], v.e[1]} {}
+  vec4(const vec3 &v, float d) : e{v.e[0], v.e[1], v.e[2], d} {}
+  vec4(float a, const vec3 &v) : e{a, v.e[0], v.e[1], v.e[2]} {}
+  vec4(const vec4 &v) : e{v.e[0], v.e[1], v.e[2], v.e[3]} {}
+  vec4 &operator=(const vec4 &v) { for (int i = 0; i < 4; i++) e[i] = v.e[i]; return *this; }
+
+  float &operator[](int i) { return e[i]; }
+  float operator[](int i) const { return e[i]; }
+};
+
+inline vec2::vec2(const vec3 &v) : e{v.e[0], v.e[1]} {}
+inline vec2::vec2(const vec4 &v) : e{v.e[0], v.e[1]} {}
+inline vec3::vec3(const vec4 &v) : e{v.e[0], v.e[1], v.e[2]} {}
+
+// component-wise arithmetic
+#define NL_VEC_OP(V, N, OP) \
+  inline V operator OP(const V &a, const V &b) { V r; for (int i = 0; i < N; i++) r.e[i] = a.e[i] OP b.e[i]; return r; } \
+  inline V operator OP(const V &a, float s) { V r; for (int i = 0; i < N; i++) r.e[i] = a.e[i] OP s; return r; } \
+  inline V operator OP(float s, const V &a) { V r; for (int i = 0; i < N; i++) r.e[i] = s OP a.e[i]; return r; } \
+  inline V &operator OP##=(V &a, const V &b) { return a = a OP b; } \
+  inline V &operator OP##=(V &a, float s) { return a = a OP s; }
+
+#define NL_VEC_OPS(V, N) \
+  NL_VEC_OP(V, N, +) \
+  NL_VEC_OP(V, N, -) \
+  NL_VEC_OP(V, N, *) \
+  NL_VEC_OP(V, N, /) \
+  inline V operator-(const V &a) { return 0.0f - a; } \
+  inline V operator+(const V &a) { return a; }
+
+NL_VEC_OPS(vec2, 2)
+NL_VEC_OPS(vec3, 3)
+NL_VEC_OPS(vec4, 4)
+
+// matrices are column major, like GLSL
+template <class V, int N>
+struct matN {
+  V c[N];
+
+  V &operator[](int i) { return c[i]; }
+  const V &operator[](int i) const { return c[i]; }
+};
+
+struct mat2 : matN<vec2, 2> {
+  mat2() {}
+  mat2(const vec2 &a, const vec2 &b) { c[0] = a; c[1] = b; }
+  mat2(float a, float b, float d, float e) { c[0] = vec2(a, b); c[1] = vec2(d, e); }
+};
+
+struct mat3 : matN<vec3, 3> {
+  mat3() {}
+  mat3(const vec3 &a, const vec3 &b, const vec3 &d) { c[0] = a; c[1] = b; c[2] = d; }
+  mat3(float m0, float m1, float m2, float m3, float m4, float m5, float m6, float m7, float m8) {
+    c[0] = vec3(m0, m1, m2); c[1] = vec3(m3, m4, m5); c[2] = vec3(m6, m7, m8);
+  }
+};
+
+struct mat4 : matN<vec4, 4> {
+  mat4() {}
+  mat4(const vec4 &a, const vec4 &b, const vec4 &d, const vec4 &f) { c[0] = a; c[1] = b; c[2] = d; c[3] = f; }
+};
+
+#define NL_MAT_OPS(M, V, N) \
+  inline V operator*(const M &m, const V &v) { V r; for (int i = 0; i < N; i++) r += m.c[i]*v.e[i]; return r; } \
+  inline V operator*(const V &v, const M &m) { V r; for (int i = 0; i < N; i++) for (int j = 0; j < N; j++) r.e[i] += v.e[j]*m.c[i].e[j]; return r; } \
+  inline M operator*(const M &a, const M &b) { M r; for (int i = 0; i < N; i++) r.c[i] = a*b.c[i]; return r; } \
+  inline V mul(const M &m, const V &v) { return m*v; } \
+  inline V mul(const V &v, const M &m) { return v*m; } \
+  inline M mul(const M &a, const M &b) { return a*b; } \
+  inline M transpose(const M &m) { M r; for (int i = 0; i < N; i++) for (int j = 0; j < N; j++) r.c[i].e[j] = m.c[j].e[i]; return r; }
+
+NL_MAT_OPS(mat2, vec2, 2)
+NL_MAT_OPS(mat3, vec3, 3)
+NL_MAT_OPS(mat4, vec4, 4)
+
+inline mat2 mtxFromCols(const vec2 &a, const vec2 &b) { return mat2(a, b); }
+inline mat3 mtxFromCols(const vec3 &a, const vec3 &b, const vec3 &c) { return mat3(a, b, c); }
+inline mat4 mtxFromCols(const vec4 &a, const vec4 &b, const vec4 &c, const vec4 &d) { return mat4(a, b, c, d); }
+inline mat2 mtxFromRows(const vec2 &a, const vec2 &b) { return transpose(mat2(a, b)); }
+inline mat3 mtxFromRows(const vec3 &a, const vec3 &b, const vec3 &c) { return transpose(mat3(a, b, c)); }
+inline mat4 mtxFromRows(const vec4 &a, const vec4 &b, const vec4 &c, const vec4 &d) { return transpose(mat4(a, b, c, d)); }
+
+inline vec2 vec2_splat(float s) { return vec2(s); }
+inline vec3 vec3_splat(float s) { return vec3(s); }
+inline vec4 vec4_splat(float s) { return vec4(s); }
+
+// scalar built-ins
+inline float radians(float x) { return x*0.017453292f; }
+inline float degrees(float x) { return x*57.29578f; }
+inline float sin(float x) { return std::sin(x); }
+inline float cos(float x) { return std::cos(x); }
+inline float tan(float x) { return std::tan(x); }
+inline float asin(float x) { return std::asin(x); }
+inline float acos(float x) { return std::acos(x); }
+inline float atan(float x) { return std::atan(x); }
+inline float atan(float y, float x) { return std::atan2(y, x); }
+inline float atan2(float y, float x) { return std::atan2(y, x); }
+inline float exp(float x) { return std::exp(x); }
+inline float exp2(float x) { return std::exp2(x); }
+inline float log(float x) { return std::log(x); }
+inline float log2(float x) { return std::log2(x); }
+inline float pow(float x, float y) { return std::pow(x, y); }
+inline float sqrt(float x) { return std::sqrt(x); }
+inline float inversesqrt(float x) { return 1.0f/std::sqrt(x); }
+inline float abs(float x) { return std::fabs(x); }
+inline float sign(float x) { return float((x > 0.0f) - (x < 0.0f)); }
+// truncation based, like GPUs, valid for |x| < 2^31
+inline float floor(float x) { float f = float(int(x)); return f > x ? f - 1.0f : f; }
+inline float ceil(float x) { return std::ceil(x); }
+inline float fract(float x) { return x - floor(x); }
+inline float mod(float x, float y) { return x - y*floor(x/y); }
+inline float min(float x, float y) { return y < x ? y : x; }
+inline float max(float x, float y) { return x < y ? y : x; }
+inline float clamp(float x, float a, float b) { return min(max(x, a), b); }
+inline float mix(float x, float y, float a) { return x*(1.0f - a) + y*a; }
+inline float step(float edge, float x) { return x < edge ? 0.0f : 1.0f; }
+inline float smoothstep(float e0, float e1, float x) {
+  float t = clamp((x - e0)/(e1 - e0), 0.0f, 1.0f);
+  return t*t*(3.0f - 2.0f*t);
+}
+
+// vector built-ins as plain overloads, so swizzles convert implicitly
+#define NL_GEN_1(F) \
+  inline vec2 F(const vec2 &a) { return vec2(F(a.e[0]), F(a.e[1])); } \
+  inline vec3 F(const vec3 &a) { return vec3(F(a.e[0]), F(a.e[1]), F(a.e[2])); } \
+  inline vec4 F(const vec4 &a) { return vec4(F(a.e[0]), F(a.e[1]), F(a.e[2]), F(a.e[3])); }
+
+#define NL_GEN_2(F, A, B, IA, IB) \
+  inline vec2 F(A(vec2) a, B(vec2) b) { return vec2(F(IA(0), IB(0)), F(IA(1), IB(1))); } \
+  inline vec3 F(A(vec3) a, B(vec3) b) { return vec3(F(IA(0), IB(0)), F(IA(1), IB(1)), F(IA(2), IB(2))); } \
+  inline vec4 F(A(vec4) a, B(vec4) b) { return vec4(F(IA(0), IB(0)), F(IA(1), IB(1)), F(IA(2), IB(2)), F(IA(3), IB(3))); }
+
+#define NL_GEN_3(F, A, B, C, IA, IB, IC) \
+  inline vec2 F(A(vec2) a, B(vec2) b, C(vec2) c) { return vec2(F(IA(0), IB(0), IC(0)), F(IA(1), IB(1), IC(1))); } \
+  inline vec3 F(A(vec3) a, B(vec3) b, C(vec3) c) { return vec3(F(IA(0), IB(0), IC(0)), F(IA(1), IB(1), IC(1)), F(IA(2), IB(2), IC(2))); } \
+  inline vec4 F(A(vec4) a, B(vec4) b, C(vec4) c) { return vec4(F(IA(0), IB(0), IC(0)), F(IA(1), IB(1), IC(1)), F(IA(2), IB(2), IC(2)), F(IA(3), IB(3), IC(3))); }
+
+#define NL_T(V) const V &
+#define NL_F(V) float
+#define NL_A(i) a.e[i]
+#define NL_B(i) b.e[i]
+#define NL_C(i) c.e[i]
+#define NL_SA(i) a
+#define NL_SB(i) b
+#define NL_SC(i) c
+
+NL_GEN_1(radians)
+NL_GEN_1(degrees)
+NL_GEN_1(sin)
+NL_GEN_1(cos)
+NL_GEN_1(tan)
+NL_GEN_1(asin)
+NL_GEN_1(acos)
+NL_GEN_1(atan)
+NL_GEN_1(exp)
+NL_GEN_1(exp2)
+NL_GEN_1(log)
+NL_GEN_1(log2)
+NL_GEN_1(sqrt)
+NL_GEN_1(inversesqrt)
+NL_GEN_1(abs)
+NL_GEN_1(sign)
+NL_GEN_1(floor)
+NL_GEN_1(ceil)
+NL_GEN_1(fract)
+
+NL_GEN_2(atan, NL_T, NL_T, NL_A, NL_B)
+NL_GEN_2(atan2, NL_T, NL_T, NL_A, NL_B)
+NL_GEN_2(pow, NL_T, NL_T, NL_A, NL_B)
+NL_GEN_2(mod, NL_T, NL_T, NL_A, NL_B)
+NL_GEN_2(mod, NL_T, NL_F, NL_A, NL_SB)
+NL_GEN_2(min, NL_T, NL_T, NL_A, NL_B)
+NL_GEN_2(min, NL_T, NL_F, NL_A, NL_SB)
+NL_GEN_2(max, NL_T, NL_T, NL_A, NL_B)
+NL_GEN_2(max, NL_T, NL_F, NL_A, NL_SB)
+NL_GEN_2(step, NL_T, NL_T, NL_A, NL_B)
+NL_GEN_2(step, NL_F, NL_T, NL_SA, NL_B)
+
+NL_GEN_3(clamp, NL_T, NL_T, NL_T, NL_A, NL_B, NL_C)
+NL_GEN_3(clamp, NL_T, NL_F, NL_F, NL_A, NL_SB, NL_SC)
+NL_GEN_3(mix, NL_T, NL_T, NL_T, NL_A, NL_B, NL_C)
+NL_GEN_3(mix, NL_T, NL_T, NL_F, NL_A, NL_B, NL_SC)
+NL_GEN_3(smoothstep, NL_T, NL_T, NL_T, NL_A, NL_B, NL_C)
+NL_GEN_3(smoothstep, NL_F, NL_F, NL_T, NL_SA, NL_SB, NL_C)
+
+// geometric built-ins
+inline float dot(float a, float b) { return a*b; }
+inline float dot(const vec2 &a, const vec2 &b) { return a.e[0]*b.e[0] + a.e[1]*b.e[1]; }
+inline float dot(const vec3 &a, const vec3 &b) { return a.e[0]*b.e[0] + a.e[1]*b.e[1] + a.e[2]*b.e[2]; }
+inline float dot(const vec4 &a, const vec4 &b) { return a.e[0]*b.e[0] + a.e[1]*b.e[1] + a.e[2]*b.e[2] + a.e[3]*b.e[3]; }
+
+#define NL_GEOMETRIC(V) \
+  inline float length(const V &a) { return sqrt(dot(a, a)); } \
+  inline float distance(const V &a, const V &b) { return length(a - b); } \
+  inline V normalize(const V &a) { return a*inversesqrt(dot(a, a)); } \
+  inline V reflect(const V &i, const V &n) { return i - 2.0f*dot(n, i)*n; }
+
+NL_GEOMETRIC(vec2)
+NL_GEOMETRIC(vec3)
+NL_GEOMETRIC(vec4)
+
+inline float length(float a) { return abs(a); }
+
+inline vec3 cross(const vec3 &a, const vec3 &b) {
+  return vec3(a.y*b.z - a.z*b.y, a.z*b.x - a.x*b.z, a.x*b.y - a.y*b.x);
+}
+
+// point sampled, repeating texture
+struct sampler2D {
+  const vec4 *texels = nullptr;
+  int width = 0;
+  int height = 0;
+};
+
+inline vec4 texture2DLod(const sampler2D &s, vec2 uv, float) {
+  if (s.texels == nullptr) {
+    return vec4(0.0f);
+  }
+  int x = int(fract(uv.x)*float(s.width)) % s.width;
+  int y = int(fract(uv.y)*float(s.height)) % s.height;
+  return s.texels[y*s.width + x];
+}
+
+inline vec4 texture2D(const sampler2D &s, vec2 uv) {
+  return texture2DLod(s, uv, 0.0f);
+}
+
+} // namespace nl
+
+#endif
@@ -0,0 +1,136 @@
+/* Error of nlRenderGodRayIntensity (fog.h) against the godray it replaced.
+ *
+ * usage: godray [-t steps]
+ *   -t  allowed error of the terrain fog alpha in 8-bit steps (default 1)
+ *
+ * Sweeps relativeDist, view direction, chunk position, time, sky light and
+ * the dawn/dusk mask. Errors are of the fog alpha RenderChunk blends with
+ * the godray, NL_GODRAY*intensity, in 8-bit steps. Godrays are only drawn
+ * where nlLod gives lod.y < 1, the "lod" row covers that range. peak is
+ * the largest fog alpha of the previous godray, for scale.
+ * Exits non-zero when the error there is above the tolerance.
+ */
+
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+#include "newb.h"
+
+using namespace nl;
+
+// previous godray, kept for reference
+namespace prev {
+
+float godRayIntensity(vec3 cPos, vec3 worldPos, float t, vec2 uv1, float relativeDist, vec3 FOG_COLOR) {
+  float fogIntensity = clamp(3.0f*(FOG_COLOR.r - FOG_COLOR.b), 0.0f, 1.0f);
+  if (fogIntensity <= 0.0f) {
+    return 0.0f;
+  }
+
+  vec3 offset = cPos - 16.0f*fract(worldPos*0.0625f);
+  offset = abs(2.0f*fract(offset*0.0625f) - 1.0f);
+  offset = offset*offset*(3.0f - 2.0f*offset);
+
+  vec3 nrmof = normalize(worldPos);
+
+  float u = nrmof.z/length(nrmof.zy);
+  float diff = dot(offset, vec3(0.1f, 0.2f, 1.0f)) + 0.07f*t;
+  float mask = nrmof.x*nrmof.x;
+
+  float vol = sin(7.0f*u + 1.5f*diff)*sin(3.0f*u + diff);
+  vol = vol*vol*mask*uv1.y*(1.0f - mask*mask);
+  vol = vol*relativeDist*relativeDist;
+  vol *= fogIntensity;
+
+  vol = smoothstep(0.0f, 0.1f, vol);
+  vol = smoothstep(0.0f, 1.0f, vol);
+
+  float scatter = exp(-relativeDist*0.1f)*(1.0f - exp(-relativeDist*0.1f));
+  vol *= scatter;
+
+  vol = smoothstep(0.0f, 0.5f, vol);
+  vol = smoothstep(0.0f, 1.0f, vol);
+
+  vol = pow(vol, NL_VFOG);
+  vol *= exp(-relativeDist*0.8f);
+
+  return vol;
+}
+
+} // namespace prev
+
+struct Error {
+  double max = 0.0;
+  double sum = 0.0;
+  double peak = 0.0; // largest previous value, for scale
+  long count = 0;
+
+  void add(double e, double value) {
+    max = e > max ? e : max;
+    peak = value > peak ? value : peak;
+    sum += e;
+    count++;
+  }
+};
+
+int main(int argc, char **argv) {
+  float tolerance = 1.0f;
+
+  for (int i = 1; i < argc; i++) {
+    if (i + 1 < argc && strcmp(argv[i], "-t") == 0) {
+      tolerance = float(atof(argv[++i]));
+    } else {
+      fprintf(stderr, "Invalid option: %s\n", argv[i]);
+      return 1;
+    }
+  }
+
+  // dusk fog colors, dawn/dusk mask 1.0 and 0.3
+  const vec3 fogColors[] = {vec3(0.85f, 0.47f, 0.28f), vec3(0.6f, 0.55f, 0.5f)};
+  const float times[] = {0.0f, 7.3f, 150.0f, 1200.0f, 3600.0f, 36000.0f};
+  const float skyLight[] = {0.25f, 0.6f, 1.0f};
+  const float renderDist = 192.0f;
+
+  Error all, lod;
+  for (const vec3 &fogColor : fogColors) {
+    for (float t : times) {
+      for (float sky : skyLight) {
+        for (int ri = 1; ri <= 200; ri++) {
+          float relativeDist = 0.01f*float(ri);
+          bool drawn = nlLod(relativeDist).y < 1.0f;
+          for (int az = 0; az < 24; az++) {
+            for (int el = -4; el <= 4; el++) {
+              float a = (float(az) + 0.5f)*NL_CONST_PI_HALF/6.0f; // off the axes, u is 0/0 on the x axis
+              float b = float(el)*NL_CONST_PI_HALF/6.0f;
+              vec3 worldPos = relativeDist*renderDist*vec3(cos(b)*cos(a), sin(b), cos(b)*sin(a));
+              // chunk local position, camera at a fractional block position
+              vec3 cPos = mod(worldPos + vec3(5.3f, 70.6f, 11.9f), 16.0f);
+              vec2 uv1 = vec2(0.0f, sky);
+
+              float ref = NL_GODRAY*255.0f*prev::godRayIntensity(cPos, worldPos, t, uv1, relativeDist, fogColor);
+              float e = abs(NL_GODRAY*255.0f*nlRenderGodRayIntensity(cPos, worldPos, t, uv1, relativeDist, fogColor) - ref);
+              all.add(e, ref);
+              if (drawn) {
+                lod.add(e, ref);
+              }
+            }
+          }
+        }
+      }
+    }
+  }
+
+  printf("fog alpha error of the godray in 8-bit steps (NL_GODRAY %.2f, NL_VFOG %.2f)\n", float(NL_GODRAY), float(NL_VFOG));
+  printf("%-22s %10s %8s %8s %8s\n", "relativeDist", "samples", "max", "mean", "peak");
+  printf("%-22s %10ld %8.3f %8.4f %8.1f\n", "0 - 2", all.count, all.max, all.count > 0 ? all.sum/all.count : 0.0, all.peak);
+  printf("%-22s %10ld %8.3f %8.4f %8.1f\n", "lod (lod.y < 1)", lod.count, lod.max, lod.count > 0 ? lod.sum/lod.count : 0.0, lod.peak);
+
+  if (lod.max > tolerance) {
+    printf("FAIL: above %.2f steps\n", tolerance);
+    return 1;
+  }
+  printf("ok: within %.2f steps\n", tolerance);
+  return 0;
+}
@@ -0,0 +1,40 @@
+#ifndef NL_CPU_HALF_H
+#define NL_CPU_HALF_H
+
+/* fp16 build of the shim: include this, then #define float _Float16 and
+ * include newb.h. g++ rounds _Float16 arithmetic to half precision after
+ * every operation, like a mediump GPU. These overloads give the <cmath>
+ * calls of glsl.h an exact match, they run in float and round the result.
+ */
+
+#include <cmath>
+
+namespace std {
+
+#define NL_HALF_1(F) \
+  inline _Float16 F(_Float16 x) { return _Float16(F(float(x))); }
+#define NL_HALF_2(F) \
+  inline _Float16 F(_Float16 x, _Float16 y) { return _Float16(F(float(x), float(y))); }
+
+NL_HALF_1(sin)
+NL_HALF_1(cos)
+NL_HALF_1(tan)
+NL_HALF_1(asin)
+NL_HALF_1(acos)
+NL_HALF_1(atan)
+NL_HALF_1(exp)
+NL_HALF_1(exp2)
+NL_HALF_1(log)
+NL_HALF_1(log2)
+NL_HALF_1(sqrt)
+NL_HALF_1(fabs)
+NL_HALF_1(ceil)
+NL_HALF_2(atan2)
+NL_HALF_2(pow)
+
+#undef NL_HALF_1
+#undef NL_HALF_2
+
+} // namespace std
+
+#endif
@@ -0,0 +1,218 @@
+/* Quality and throughput of the hashes in include/newb/functions/hash.h
+ * against the sin based hashes they replaced.
+ *
+ * usage: hash [-m min_ms]
+ *   -m  minimum measuring time per hash (default 200 ms)
+ *
+ * For each input set: mean, variance (uniform: 0.0833), chi-square over
+ * 64 bins (63 dof, ~63 expected), correlation with the next input, and
+ * the number of distinct values. Every input of a set is distinct, repeated
+ * inputs would raise the chi-square of any hash. fp16 rows evaluate hash.h
+ * with every operation rounded to half precision (hash.fp16.cpp), as a GPU
+ * without highp would.
+ * Exits non-zero when a hash row marked with a limit has a chi-square above
+ * 103.5, which 0.1% of truly random values exceed.
+ * ns/call is CPU time. sin is much more expensive on mobile GPUs than
+ * on a CPU, so the real gap is larger.
+ */
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <set>
+#include <vector>
+
+#include "newb.h"
+
+using namespace nl;
+
+static double gMinSeconds = 0.2;
+static volatile float gSink;
+static int gFailed = 0;
+
+// chi-square over 64 bins that 0.1% of uniform random values exceed
+static const double kChi2Limit = 103.5;
+
+// hash.fp16.cpp
+namespace nl16 {
+float hash12Half(float x, float y);
+}
+
+// previous hashes, kept for reference
+namespace prev {
+
+float rand(vec2 n) { return fract(sin(dot(n, vec2(12.9898f, 4.1414f)))*43758.5453f); }
+float fastRand(vec2 n) { return fract(37.45f*sin(dot(n, vec2(4.36f, 8.28f)))); }
+float hashS(vec2 x) { return fract(sin(dot(x, vec2(11.0f, 57.0f)))*4e3f); }
+float hash1D(float x) { return fract(sin(x)*84.85f); }
+
+} // namespace prev
+
+// fp16 evaluation, rounding after every operation
+namespace half {
+
+typedef _Float16 h;
+
+h fr(h x) { return h(float(x) - std::floor(float(x))); }
+
+float rand(float x, float y) {
+  h d = h(h(h(x)*h(12.9898f)) + h(h(y)*h(4.1414f)));
+  return float(fr(h(h(std::sin(float(d)))*h(43758.5453f))));
+}
+
+float fastRand(float x, float y) {
+  h d = h(h(h(x)*h(4.36f)) + h(h(y)*h(8.28f)));
+  return float(fr(h(h(37.45f)*h(std::sin(float(d))))));
+}
+
+} // namespace half
+
+// input sets, each a list of points in call order (neighbours adjacent)
+static std::vector<vec2> lattice2D() {
+  // cloud cells, some time after the start of the world
+  std::vector<vec2> p;
+  for (int y = 0; y < 256; y++) {
+    for (int x = 0; x < 256; x++) {
+      p.push_back(vec2(float(x + 1500), float(y - 700)));
+    }
+  }
+  return p;
+}
+
+static std::vector<vec2> lattice1D() {
+  // torch flicker cells, t*9 over the first hour
+  std::vector<vec2> p;
+  for (int x = 0; x < 32768; x++) {
+    p.push_back(vec2(float(x), 0.0f));
+  }
+  return p;
+}
+
+static std::vector<vec2> tiled() {
+  // tiledCpos.xz + tiledCpos.y of wave phase, a 1/16 lattice over [0,2)
+  // puddles and disp hash the [0,1) and [1,2) corners of it
+  std::vector<vec2> p;
+  for (int z = 0; z < 32; z++) {
+    for (int x = 0; x < 32; x++) {
+      p.push_back(vec2(float(x), float(z))*0.0625f);
+    }
+  }
+  return p;
+}
+
+// limit: check the chi-square against kChi2Limit
+template <class F>
+static void quality(const char *name, const std::vector<vec2> &points, F fn, bool limit = false) {
+  const int bins = 64;
+  std::vector<float> v;
+  v.reserve(points.size());
+  for (const vec2 &p : points) {
+    v.push_back(fn(p));
+  }
+
+  double n = double(v.size());
+  double mean = 0.0, var = 0.0;
+  std::vector<int> hist(bins, 0);
+  for (float x : v) {
+    mean += x;
+    int b = int(x*bins);
+    hist[b < 0 ? 0 : (b >= bins ? bins - 1 : b)]++;
+  }
+  mean /= n;
+  for (float x : v) {
+    var += (x - mean)*(x - mean);
+  }
+  var /= n;
+
+  double chi2 = 0.0, e = n/bins;
+  for (int c : hist) {
+    chi2 += (c - e)*(c - e)/e;
+  }
+
+  double corr = 0.0;
+  for (size_t i = 0; i + 1 < v.size(); i++) {
+    corr += (v[i] - mean)*(v[i + 1] - mean);
+  }
+  corr /= (n - 1.0)*(var > 0.0 ? var : 1.0);
+
+  std::set<float> distinct(v.begin(), v.end());
+
+  bool failed = limit && chi2 > kChi2Limit;
+  gFailed += failed ? 1 : 0;
+  printf("  %-18s %7.3f %8.4f %10.1f %+7.3f %9zu%s\n", name, mean, var, chi2, corr, distinct.size(),
+         failed ? "  FAIL" : (limit ? "  ok" : ""));
+}
+
+template <class F>
+static void throughput(const char *name, F fn) {
+  using clock = std::chrono::steady_clock;
+  std::vector<vec2> points = lattice2D();
+  double best = 1e30;
+  for (int trial = 0; trial < 5; trial++) {
+    long calls = 0;
+    float sink = 0.0f;
+    auto start = clock::now();
+    double elapsed;
+    do {
+      for (const vec2 &p : points) {
+        sink += fn(p);
+      }
+      calls += long(points.size());
+      elapsed = std::chrono::duration<double>(clock::now() - start).count();
+    } while (elapsed < gMinSeconds/5.0);
+    gSink = sink;
+    double ns = 1e9*elapsed/double(calls);
+    best = ns < best ? ns : best;
+  }
+  printf("  %-18s %7.2f\n", name, best);
+}
+
+static void header(const char *set) {
+  printf("%s\n  %-18s %7s %8s %10s %7s %9s\n", set, "hash", "mean", "var", "chi2", "corr", "distinct");
+}
+
+int main(int argc, char **argv) {
+  for (int i = 1; i < argc; i++) {
+    if (i + 1 < argc && strcmp(argv[i], "-m") == 0) {
+      gMinSeconds = atof(argv[++i])*0.001;
+    } else {
+      fprintf(stderr, "Invalid option: %s\n", argv[i]);
+      return 1;
+    }
+  }
+
+  header("2D lattice (randt, stars)");
+  const std::vector<vec2> l2 = lattice2D();
+  quality("prev rand", l2, [](vec2 p) { return prev::rand(p); });
+  quality("prev hashS", l2, [](vec2 p) { return prev::hashS(p); });
+  quality("hash12", l2, [](vec2 p) { return hash12(p); }, true);
+  // highp call sites, large cells keep no fraction in fp16
+  quality("prev rand fp16", l2, [](vec2 p) { return half::rand(p.x, p.y); });
+  quality("hash12 fp16", l2, [](vec2 p) { return nl16::hash12Half(p.x, p.y); });
+
+  header("1D lattice (noise1D)");
+  const std::vector<vec2> l1 = lattice1D();
+  quality("prev sin", l1, [](vec2 p) { return prev::hash1D(p.x); });
+  quality("hash11", l1, [](vec2 p) { return hash11(p.x); }, true);
+
+  header("1/16 lattice (disp, puddles, wave phase)");
+  const std::vector<vec2> t = tiled();
+  quality("prev fastRand", t, [](vec2 p) { return prev::fastRand(p); });
+  quality("hash12", t, [](vec2 p) { return hash12(p); }, true);
+  quality("prev fastRand fp16", t, [](vec2 p) { return half::fastRand(p.x, p.y); });
+  quality("hash12 fp16", t, [](vec2 p) { return nl16::hash12Half(p.x, p.y); }, true);
+
+  printf("throughput\n  %-18s %7s\n", "hash", "ns/call");
+  throughput("prev rand", [](vec2 p) { return prev::rand(p); });
+  throughput("prev fastRand", [](vec2 p) { return prev::fastRand(p); });
+  throughput("prev sin 1D", [](vec2 p) { return prev::hash1D(p.x); });
+  throughput("hash11", [](vec2 p) { return hash11(p.x); });
+  throughput("hash12", [](vec2 p) { return hash12(p); });
+
+  if (gFailed > 0) {
+    printf("FAIL: %d hashes over chi-square %.1f\n", gFailed, kChi2Limit);
+    return 1;
+  }
+  return 0;
+}
@@ -0,0 +1,19 @@
+/* include/newb/functions/hash.h built with _Float16 instead of float, see hash.cpp */
+
+#include <cmath>
+
+#include "half.h"
+
+// float of the fp32 build, for the interface to hash.cpp
+typedef float f32;
+
+// own namespace, the vector types differ from the fp32 build
+#define nl nl16
+#define float _Float16
+#include "newb.h"
+
+namespace nl {
+
+f32 hash12Half(f32 x, f32 y) { return f32(hash12(vec2(float(x), float(y)))); }
+
+} // namespace nl
@@ -0,0 +1,14 @@
+#ifndef NL_CPU_NEWB_H
+#define NL_CPU_NEWB_H
+
+/* include/newb compiled as C++ inside namespace nl.
+ * bench.sh puts the patched copy of include/newb on the include path.
+ */
+
+#include "glsl.h"
+
+namespace nl {
+#include <newb/main.sh>
+} // namespace nl
+
+#endif
@@ -0,0 +1,70 @@
+/* Sky pixels shaded twice per frame: by the Sky dome and by LegacyCubemap.
+ *
+ * usage: overdraw [-w width] [-h height] [-f fov]
+ *   -w, -h  screen size in pixels (default 3200x1440, a 1440p phone)
+ *   -f      vertical field of view in degrees (default 70)
+ *
+ * Both materials cover the whole screen before terrain is drawn. Without
+ * NL_CUBEMAP_TRUST_SKY LegacyCubemap evaluates nlRenderSky on every pixel
+ * whose texel is not opaque, so all of them are shaded twice when the
+ * cubemap texture is translucent. With it, only pixels below the horizon
+ * (fade > 0) are, as the dome already drew the same gradient above it.
+ * Opaque cubemap texels lower both counts further, they are not modeled.
+ */
+
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+#include "newb.h"
+
+using namespace nl;
+
+int main(int argc, char **argv) {
+  int width = 3200;
+  int height = 1440;
+  float fov = 70.0f;
+
+  for (int i = 1; i < argc; i++) {
+    if (i + 1 < argc && strcmp(argv[i], "-w") == 0) {
+      width = atoi(argv[++i]);
+    } else if (i + 1 < argc && strcmp(argv[i], "-h") == 0) {
+      height = atoi(argv[++i]);
+    } else if (i + 1 < argc && strcmp(argv[i], "-f") == 0) {
+      fov = float(atof(argv[++i]));
+    } else {
+      fprintf(stderr, "Invalid option: %s\n", argv[i]);
+      return 1;
+    }
+  }
+  if (width <= 0 || height <= 0) {
+    fprintf(stderr, "Error: invalid screen size\n");
+    return 1;
+  }
+
+  const float tanY = tan(0.5f*fov*NL_CONST_PI_HALF/90.0f);
+  const double pixels = double(width)*double(height);
+
+  printf("%dx%d, fov %.0f: %.2f M pixels, all shaded twice without NL_CUBEMAP_TRUST_SKY\n",
+         width, height, fov, pixels*1e-6);
+  printf("%8s %18s %10s\n", "pitch", "shaded twice (M)", "share");
+
+  for (int pitch = -60; pitch <= 60; pitch += 15) {
+    float a = float(pitch)*NL_CONST_PI_HALF/90.0f;
+    vec3 forward = vec3(0.0f, sin(a), cos(a));
+    vec3 up = vec3(0.0f, cos(a), -sin(a));
+
+    // fade > 0 where viewDir.y < 0, and the sign of viewDir.y only depends on the row
+    long twice = 0;
+    for (int y = 0; y < height; y++) {
+      float ny = 1.0f - 2.0f*(float(y) + 0.5f)/float(height);
+      vec3 viewDir = forward + up*(ny*tanY);
+      float fade = clamp(-10.0f*viewDir.y, 0.0f, 1.0f);
+      twice += fade > 0.0f ? width : 0;
+    }
+    printf("%8d %18.2f %9.1f%%\n", pitch, double(twice)*1e-6, 100.0*double(twice)/pixels);
+  }
+
+  return 0;
+}
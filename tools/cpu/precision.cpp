@@ -0,0 +1,116 @@
+/* fp16 error of the fragment stage functions built at mediump by NL_MEDIUMP.
+ *
+ * usage: precision [-e state]
+ *   -e  only use inputs of one scene state (day, dusk, night, rain, nether, end, underwater)
+ *
+ * Every function runs over the same inputs twice: built with float
+ * (precision.cpp) and with an fp16 scalar that rounds after every
+ * operation (precision.fp16.cpp, see half.h). Linear colors go through
+ * fp32 colorCorrection before they are compared (bloom and rainbow added
+ * to the fp32 sky gradient first), so all errors are in 8-bit steps of
+ * the final pixel. An error up to 1 step is not
+ * visible. Rows with a wrap period get game time wrapped by nlWrapTime
+ * in the fp16 run, the fp32 reference always uses unwrapped game time
+ * (0 to 1 h).
+ */
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+
+#include "precision.h"
+#include "scene.h"
+
+namespace nl {
+#include "precision_kernels.h"
+} // namespace nl
+
+using namespace nl;
+
+static void copy3(float *dst, vec3 v) {
+  dst[0] = v.x;
+  dst[1] = v.y;
+  dst[2] = v.z;
+}
+
+static PixelIn pixel(const Sample &s) {
+  PixelIn p;
+  copy3(p.viewDir, s.viewDir);
+  copy3(p.color, s.color.rgb);
+  copy3(p.fogColor, s.fogColor);
+  copy3(p.zenithCol, s.zenithCol);
+  copy3(p.horizonCol, s.horizonCol);
+  copy3(p.horizonEdgeCol, s.horizonEdgeCol);
+  p.rainFactor = s.rainFactor;
+  p.t = s.t;
+  p.underWater = s.underWater;
+  return p;
+}
+
+// final 8-bit value of an output channel
+static float steps(const Kernel &k, const Sample &s, const PixelOut &o, int i) {
+  vec3 c = vec3(o.rgb[0], o.rgb[1], o.rgb[2]);
+  if (k.output == kSkyTerm) {
+    c += renderOverworldSky(s.horizonEdgeCol, s.horizonCol, s.zenithCol, s.viewDir);
+  }
+  if (k.output != kDisplay) {
+    c = colorCorrection(c);
+  }
+  return 255.0f*clamp(c[i], 0.0f, 1.0f);
+}
+
+int main(int argc, char **argv) {
+  const char *state = nullptr;
+
+  for (int i = 1; i < argc; i++) {
+    if (i + 1 < argc && strcmp(argv[i], "-e") == 0) {
+      state = argv[++i];
+    } else {
+      fprintf(stderr, "Invalid option: %s\n", argv[i]);
+      return 1;
+    }
+  }
+
+  const std::vector<Sample> samples = makeSamples(4096, 1u, state);
+  if (samples.empty()) {
+    fprintf(stderr, "Error: unknown scene state %s\n", state);
+    return 1;
+  }
+
+  printf("%-20s %9s %8s %8s %9s\n", "function", "time wrap", "max", "mean", ">1 step");
+  for (int k = 0; k < kKernelCount; k++) {
+    const Kernel &k32 = nl::kKernels[k];
+    const Kernel &k16 = nl16::kKernels[k];
+
+    double maxErr = 0.0, sumErr = 0.0;
+    long visible = 0, count = 0;
+    for (const Sample &s : samples) {
+      PixelIn p = pixel(s);
+      PixelOut ref, out;
+      k32.fn(p, ref);
+      if (k16.period > 0.0f) {
+        p.t = nlWrapTime(p.t, k16.period);
+      }
+      k16.fn(p, out);
+
+      for (int i = 0; i < 3; i++) {
+        double err = std::fabs(double(steps(k32, s, out, i)) - double(steps(k32, s, ref, i)));
+        maxErr = err > maxErr ? err : maxErr;
+        sumErr += err;
+        visible += err > 1.0 ? 1 : 0;
+        count++;
+      }
+    }
+
+    char wrap[16] = "-";
+    if (k16.period > 0.0f) {
+      snprintf(wrap, sizeof(wrap), "%.1f s", k16.period);
+    } else if (k16.period == 0.0f) {
+      snprintf(wrap, sizeof(wrap), "none");
+    }
+    printf("%-20s %9s %8.2f %8.3f %8.2f%%\n", k32.name, wrap, maxErr, sumErr/double(count), 100.0*double(visible)/double(count));
+  }
+
+  return 0;
+}
@@ -0,0 +1,16 @@
+/* include/newb built with _Float16 instead of float, see precision.cpp */
+
+#include <cmath>
+#include <cstring>
+
+#include "half.h"
+#include "precision.h"
+
+// own namespace, the vector types differ from the fp32 build
+#define nl nl16
+#define float _Float16
+#include "newb.h"
+
+namespace nl {
+#include "precision_kernels.h"
+} // namespace nl
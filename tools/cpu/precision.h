@@ -0,0 +1,54 @@
+#ifndef NL_CPU_PRECISION_H
+#define NL_CPU_PRECISION_H
+
+/* Interface between precision.cpp (fp32) and precision.fp16.cpp, which
+ * compiles include/newb a second time with every float replaced by half.
+ * Only plain floats cross it, the two builds have different vector types.
+ */
+
+// float of the fp32 build, precision.fp16.cpp redefines float
+typedef float f32;
+
+// one pixel of fragment stage inputs
+struct PixelIn {
+  float viewDir[3];
+  float color[3];
+  float fogColor[3];
+  float zenithCol[3];
+  float horizonCol[3];
+  float horizonEdgeCol[3];
+  float rainFactor;
+  float t;
+  bool underWater;
+};
+
+struct PixelOut {
+  float rgb[3];
+};
+
+// what a kernel output is, compared in 8-bit steps of the final pixel
+enum Output {
+  kDisplay, // after colorCorrection, compared as is
+  kLinear,  // linear color, compared after fp32 colorCorrection
+  kSkyTerm, // added to the fp32 sky gradient, then as kLinear
+};
+
+struct Kernel {
+  const char *name;
+  Output output;
+  // time wrap period of the fp16 run, 0: unwrapped game time, -1: no time input
+  float period;
+  void (*fn)(const PixelIn &, PixelOut &);
+};
+
+namespace nl {
+extern const Kernel kKernels[];
+extern const int kKernelCount;
+}
+
+namespace nl16 {
+extern const Kernel kKernels[];
+extern const int kKernelCount;
+}
+
+#endif
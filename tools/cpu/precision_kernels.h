@@ -0,0 +1,50 @@
+/* Fragment stage functions compared by precision.cpp.
+ * Included once per precision, inside the namespace of that build.
+ */
+
+static vec3 in3(const f32 *p) {
+  return vec3(p[0], p[1], p[2]);
+}
+
+static void out3(PixelOut &o, vec3 c) {
+  o.rgb[0] = c.x;
+  o.rgb[1] = c.y;
+  o.rgb[2] = c.z;
+}
+
+static void kColorCorrection(const PixelIn &p, PixelOut &o) {
+  out3(o, colorCorrection(4.0f*in3(p.color)));
+}
+
+static void kOverworldSky(const PixelIn &p, PixelOut &o) {
+  out3(o, renderOverworldSky(in3(p.horizonEdgeCol), in3(p.horizonCol), in3(p.zenithCol), in3(p.viewDir)));
+}
+
+static void kSunBloom(const PixelIn &p, PixelOut &o) {
+  out3(o, getSunBloom(p.viewDir[0], in3(p.horizonEdgeCol), in3(p.fogColor)));
+}
+
+static void kSpectrum(const PixelIn &p, PixelOut &o) {
+  out3(o, spectrum((p.viewDir[2] + 0.6f)*8.0f));
+}
+
+static void kRenderSky(const PixelIn &p, PixelOut &o) {
+  out3(o, nlRenderSky(in3(p.horizonEdgeCol), in3(p.horizonCol), in3(p.zenithCol), -in3(p.viewDir), in3(p.fogColor),
+                      p.t, p.rainFactor, false, p.underWater, false));
+}
+
+static void kEndSky(const PixelIn &p, PixelOut &o) {
+  out3(o, renderEndSky(getEndHorizonCol(), getEndZenithCol(), in3(p.viewDir), p.t));
+}
+
+extern const Kernel kKernels[] = {
+  {"colorCorrection", kDisplay, -1.0f, kColorCorrection},
+  {"renderOverworldSky", kLinear, -1.0f, kOverworldSky},
+  {"getSunBloom", kSkyTerm, -1.0f, kSunBloom},
+  {"spectrum", kSkyTerm, -1.0f, kSpectrum},
+  {"nlRenderSky", kLinear, NL_TIME_PERIOD_SKY, kRenderSky},
+  {"nlRenderSky", kLinear, 0.0f, kRenderSky},
+  {"renderEndSky", kLinear, NL_TIME_PERIOD_END, kEndSky},
+  {"renderEndSky", kLinear, 0.0f, kEndSky},
+};
+extern const int kKernelCount = sizeof(kKernels)/sizeof(kKernels[0]);
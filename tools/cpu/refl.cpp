@@ -0,0 +1,127 @@
+/* Ground reflection weight of terrain quads in rain (rain.h).
+ *
+ * usage: refl
+ *
+ * Each quad is four RenderChunk vertices with the color vanilla bakes in
+ * (biome tint x face shade x ambient occlusion). The vertex stage is
+ * RenderChunk.vertex.sc: block class, shade, nlReflShade and nlRefl. The
+ * fragment stage keeps the reflection where nlFlatFace passes for the world
+ * y derivative of the quad, taken over 32 pixels of screen height.
+ * The weight is the v_refl.a a fragment at the vertex blends with, and the
+ * reference is the fragment mask RenderChunk used before nlReflShade:
+ *   v_refl.a*(clamp(shade*10, 8.2, 8.8) - 7.8) on faces passing the dFdy test.
+ * Exits non-zero when a weight differs from the reference, when a top face
+ * vertex does not reflect or when a side face or cross plant vertex does.
+ */
+
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+
+#include "newb.h"
+
+using namespace nl;
+
+struct Quad {
+  const char *name;
+  vec3 tint;       // biome tint, 1.0 for untinted blocks
+  float shade[4];  // face shade times ambient occlusion per vertex
+  const vec3 *pos; // block local position of the 4 vertices
+  bool top;        // upward face, must reflect
+};
+
+int main(int argc, char **argv) {
+  if (argc > 1) {
+    fprintf(stderr, "Invalid option: %s\n", argv[1]);
+    return 1;
+  }
+
+  const vec3 plainsGrass = vec3(0.569f, 0.741f, 0.349f);
+  const vec3 swampGrass = vec3(0.416f, 0.439f, 0.224f);
+  const vec3 plainsFoliage = vec3(0.467f, 0.671f, 0.184f);
+  const vec3 none = vec3_splat(1.0f);
+
+  const vec3 top[4] = {vec3(0.0f, 1.0f, 0.0f), vec3(1.0f, 1.0f, 0.0f), vec3(1.0f, 1.0f, 1.0f), vec3(0.0f, 1.0f, 1.0f)};
+  const vec3 side[4] = {vec3(0.0f, 0.0f, 0.0f), vec3(1.0f, 0.0f, 0.0f), vec3(1.0f, 1.0f, 0.0f), vec3(0.0f, 1.0f, 0.0f)};
+  const vec3 cross[4] = {vec3(0.15f, 0.0f, 0.15f), vec3(0.85f, 0.0f, 0.85f), vec3(0.85f, 1.0f, 0.85f), vec3(0.15f, 1.0f, 0.15f)};
+
+  const Quad quads[] = {
+    {"stone top", none, {1.0f, 1.0f, 1.0f, 1.0f}, top, true},
+    {"stone top, AO corners", none, {1.0f, 0.8f, 0.5f, 0.3f}, top, true},
+    {"grass top, plains", plainsGrass, {1.0f, 1.0f, 1.0f, 1.0f}, top, true},
+    {"grass top, swamp", swampGrass, {1.0f, 1.0f, 1.0f, 1.0f}, top, true},
+    {"grass top, swamp, AO", swampGrass, {1.0f, 0.7f, 0.5f, 0.5f}, top, true},
+    {"leaves top, plains", plainsFoliage, {1.0f, 1.0f, 1.0f, 1.0f}, top, true},
+    {"stone side", none, {0.8f, 0.8f, 0.8f, 0.8f}, side, false},
+    {"stone side, AO", none, {0.6f, 0.6f, 0.4f, 0.3f}, side, false},
+    {"leaves side, plains", plainsFoliage, {0.8f, 0.8f, 0.8f, 0.8f}, side, false},
+    {"flower (cross)", none, {1.0f, 1.0f, 1.0f, 1.0f}, cross, false},
+    {"tall grass (cross)", plainsGrass, {1.0f, 1.0f, 1.0f, 1.0f}, cross, false},
+  };
+
+  // rain, camera 2 blocks above the quads
+  const vec3 horizonEdgeCol = vec3(0.4f, 0.45f, 0.5f);
+  const vec3 horizonCol = vec3(0.35f, 0.4f, 0.45f);
+  const vec3 zenithCol = vec3(0.2f, 0.25f, 0.3f);
+  const vec3 fogColor = vec3(0.4f, 0.45f, 0.5f);
+  const vec3 camPos = vec3(3.3f, 66.0f, 5.7f);
+  const vec3 chunkPos = vec3(4.0f, 63.0f, 6.0f);
+  const vec2 uv1 = vec2(0.0f, 1.0f);
+  const float rainFactor = 1.0f;
+  const float renderDist = 192.0f;
+  const float t = 10.0f;
+
+  int failed = 0;
+  printf("%-24s %8s %8s %8s %8s   %s\n", "quad", "v0", "v1", "v2", "v3", "reference");
+  for (const Quad &q : quads) {
+
+    // fragment derivative of world y, the quad covers 32 pixels of height
+    float ymin = q.pos[0].y, ymax = q.pos[0].y;
+    for (int i = 1; i < 4; i++) {
+      ymin = min(ymin, q.pos[i].y);
+      ymax = max(ymax, q.pos[i].y);
+    }
+    bool flat = nlFlatFace((ymax - ymin)/32.0f);
+
+    float weight[4], reference[4];
+    for (int i = 0; i < 4; i++) {
+      vec3 cPos = chunkPos + q.pos[i];
+      vec3 worldPos = cPos - camPos;
+      vec4 color = vec4(q.tint*q.shade[i], 1.0f);
+
+      // RenderChunk.vertex.sc
+      int block = nlBlockClass(color, fract(cPos), vec2(0.5f, 0.5f));
+      bool isColored = nlBlockIs(block, NL_BLOCK_COLORED);
+      float shade = isColored ? color.g*1.5f : color.g;
+      float camDist = length(worldPos);
+      vec3 viewDir = -worldPos/camDist;
+      vec2 lit = uv1*uv1;
+      vec3 torchColor = vec3(1.0f, 0.52f, 0.18f);
+
+      vec4 c = color;
+      vec4 fog = vec4(fogColor, 0.0f);
+      vec4 refl = nlRefl(c, fog, lit, uv1, fract(cPos*0.0625f), nlReflShade(shade), camDist, worldPos, viewDir, torchColor,
+                         horizonEdgeCol, horizonCol, zenithCol, fogColor, rainFactor, renderDist, t, worldPos, false, false, false);
+      c = color;
+      fog = vec4(fogColor, 0.0f);
+      vec4 plain = nlRefl(c, fog, lit, uv1, fract(cPos*0.0625f), 1.0f, camDist, worldPos, viewDir, torchColor,
+                          horizonEdgeCol, horizonCol, zenithCol, fogColor, rainFactor, renderDist, t, worldPos, false, false, false);
+
+      weight[i] = flat ? refl.a : 0.0f;
+      reference[i] = q.top ? plain.a*(clamp(shade*10.0f, 8.2f, 8.8f) - 7.8f) : 0.0f;
+
+      bool ok = abs(weight[i] - reference[i]) < 1e-5f && (q.top ? weight[i] > 0.0f : weight[i] == 0.0f);
+      failed += ok ? 0 : 1;
+    }
+
+    printf("%-24s %8.4f %8.4f %8.4f %8.4f   %.4f %.4f %.4f %.4f\n", q.name,
+           weight[0], weight[1], weight[2], weight[3], reference[0], reference[1], reference[2], reference[3]);
+  }
+
+  if (failed > 0) {
+    printf("FAIL: %d vertices off the reference or reflecting on the wrong face\n", failed);
+    return 1;
+  }
+  printf("ok: top faces reflect, side faces and cross plants do not\n");
+  return 0;
+}
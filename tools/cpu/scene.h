@@ -0,0 +1,140 @@
+#ifndef NL_CPU_SCENE_H
+#define NL_CPU_SCENE_H
+
+/* Fixed input sets for CPU runs of include/newb.
+ * Inputs are generated from a seeded LCG, so every run (and every
+ * machine) sees the same values.
+ */
+
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+#include "newb.h"
+
+namespace nl {
+
+// uniform state of one frame, as the game would set it
+struct SceneState {
+  const char *name;
+  vec3 fogColor;
+  vec3 fogControl; // FogAndDistanceControl.xyz
+};
+
+// render distance 12 chunks (z = 192 blocks)
+// fog values of the last three pass detectNether, detectEnd and detectUnderwater
+static const SceneState kSceneStates[] = {
+  {"day", vec3(0.66f, 0.82f, 1.0f), vec3(0.604f, 1.0f, 192.0f)},
+  {"dusk", vec3(0.85f, 0.47f, 0.28f), vec3(0.604f, 1.0f, 192.0f)},
+  {"night", vec3(0.02f, 0.03f, 0.06f), vec3(0.604f, 1.0f, 192.0f)},
+  {"rain", vec3(0.31f, 0.34f, 0.39f), vec3(0.23f, 0.70f, 192.0f)},
+  {"nether", vec3(0.33f, 0.04f, 0.02f), vec3(0.05f, 0.5f, 192.0f)},
+  {"end", vec3(0.45f, 0.0f, 0.45f), vec3(0.3f, 1.0f, 192.0f)},
+  {"underwater", vec3(0.02f, 0.16f, 0.35f), vec3(0.0f, 0.6f, 192.0f)},
+};
+static const int kSceneStateCount = sizeof(kSceneStates)/sizeof(kSceneStates[0]);
+
+struct Rng {
+  uint32_t s;
+
+  explicit Rng(uint32_t seed) : s(seed) {}
+
+  float next() {
+    s = s*1664525u + 1013904223u;
+    return float(s >> 8)*(1.0f/16777216.0f);
+  }
+  float range(float a, float b) { return a + (b - a)*next(); }
+};
+
+// one vertex/pixel worth of shader inputs
+struct Sample {
+  vec3 viewDir;
+  vec3 worldPos;
+  vec3 cPos;
+  vec3 bPos;
+  vec3 tiledCpos;
+  vec4 color;
+  vec2 uv0;
+  vec2 uv1;
+  vec2 lit;
+  float camDist;
+  float relativeDist;
+  float t;
+
+  // frame uniforms and the sky colors derived from them
+  vec3 fogColor;
+  vec3 fogControl;
+  float rainFactor;
+  bool end;
+  bool nether;
+  bool underWater;
+  vec3 zenithCol;
+  vec3 horizonCol;
+  vec3 horizonEdgeCol;
+};
+
+inline Sample makeSample(Rng &rng, const SceneState &state) {
+  Sample s;
+
+  s.cPos = vec3(rng.range(0.0f, 16.0f), rng.range(0.0f, 16.0f), rng.range(0.0f, 16.0f));
+  s.bPos = fract(s.cPos);
+  s.tiledCpos = fract(s.cPos*0.0625f);
+  s.worldPos = vec3(rng.range(-96.0f, 96.0f), rng.range(-24.0f, 8.0f), rng.range(-96.0f, 96.0f));
+  s.camDist = length(s.worldPos);
+  s.viewDir = -s.worldPos/s.camDist;
+  s.relativeDist = s.camDist/state.fogControl.z;
+  s.color = vec4(rng.range(0.4f, 1.0f), rng.range(0.6f, 1.0f), rng.range(0.2f, 1.0f), rng.range(0.6f, 1.0f));
+  s.uv0 = vec2(rng.next(), rng.next());
+  s.uv1 = vec2(rng.next(), rng.range(0.5f, 1.0f));
+  s.lit = s.uv1*s.uv1;
+  s.t = rng.range(0.0f, 3600.0f);
+
+  s.fogColor = state.fogColor;
+  s.fogControl = state.fogControl;
+  s.end = detectEnd(s.fogColor, s.fogControl.xy);
+  s.nether = detectNether(s.fogColor, s.fogControl.xy);
+  s.underWater = detectUnderwater(s.fogColor, s.fogControl.xy);
+  s.rainFactor = detectRain(s.fogControl);
+
+  // as in RenderChunk.vertex.sc
+  if (s.underWater) {
+    s.zenithCol = getUnderwaterCol(s.fogColor);
+    s.horizonCol = s.zenithCol;
+    s.horizonEdgeCol = s.zenithCol;
+  } else if (s.end) {
+    s.zenithCol = getEndZenithCol();
+    s.horizonCol = getEndHorizonCol();
+    s.horizonEdgeCol = s.horizonCol;
+  } else {
+    vec3 fs = getSkyFactors(s.fogColor);
+    s.zenithCol = getZenithCol(s.rainFactor, s.fogColor, fs);
+    s.horizonCol = getHorizonCol(s.rainFactor, s.fogColor, fs);
+    s.horizonEdgeCol = getHorizonEdgeCol(s.horizonCol, s.rainFactor, s.fogColor);
+  }
+
+  return s;
+}
+
+// samples cycle through all scene states, or use only the one named state
+inline std::vector<Sample> makeSamples(int count, uint32_t seed = 1u, const char *state = nullptr) {
+  std::vector<const SceneState *> states;
+  for (int i = 0; i < kSceneStateCount; i++) {
+    if (state == nullptr || strcmp(state, kSceneStates[i].name) == 0) {
+      states.push_back(&kSceneStates[i]);
+    }
+  }
+  Rng rng(seed);
+  std::vector<Sample> samples;
+  if (states.empty()) {
+    return samples;
+  }
+  samples.reserve(count);
+  for (int i = 0; i < count; i++) {
+    samples.push_back(makeSample(rng, *states[i % states.size()]));
+  }
+  return samples;
+}
+
+} // namespace nl
+
+#endif
@@ -0,0 +1,247 @@
+#!/usr/bin/env python3
+"""Offscreen frame time of compiled GLSL/ESSL shaders under Mesa llvmpipe.
+
+Walks a directory of unpacked material.bin files (see report.sh) laid out as
+<variant>/<material>/..., pairs every vertex shader with the fragment shader
+of the same pass and permutation, and times both on the canned scene of its
+material with the frame runner (tools/gles/frame.cpp, built by frame.sh):
+RenderChunk on a terrain chunk mesh (a water sheet for passes named
+Transparent), Sky, EndSky and LegacyCubemap on a sky dome, Clouds on the
+cloud plane. Materials without a scene (Actor, SunMoon) are skipped.
+
+Prints ms per frame for every scene state (day, dusk, night, rain, nether,
+end, underwater) of the slowest permutation per variant and material, and a
+frame total per variant: the sum of its materials. Tables can be saved and
+later runs diffed against them like the static cost report; the diff is of
+the time summed over all states per permutation, as single states of a
+software renderer vary by several percent between runs. Shaders that fail
+to compile or link are errors.
+
+Pairs are found by replacing the stage name in the shader path (Vertex and
+Fragment, any case). A directory with a single vertex shader pairs it with
+all of its fragment shaders.
+"""
+
+import argparse
+import os
+import re
+import subprocess
+import sys
+
+from shader_cost import read_shader
+
+SCENES = {
+    'RenderChunk': 'terrain',
+    'Sky': 'sky',
+    'EndSky': 'sky',
+    'LegacyCubemap': 'sky',
+    'Clouds': 'clouds',
+}
+STAGE_RE = re.compile(r'vertex|fragment', re.IGNORECASE)
+# permutations faster than this over all states are not diffed, their time is mostly noise
+MIN_MS = 1.0
+
+
+def scene_of(material, shader):
+    scene = SCENES.get(material)
+    if scene == 'terrain' and 'transparent' in shader.lower():
+        return 'water'
+    return scene
+
+
+def collect(root, material_filter=None):
+    """Vertex/fragment pairs as (variant, material, shader, scene, vs, fs), and skipped materials."""
+    shaders = {}
+    for dirpath, _, files in os.walk(root):
+        for name in sorted(files):
+            if name.endswith('.material.bin'):
+                continue
+            path = os.path.join(dirpath, name)
+            text = read_shader(path)
+            if text is None:
+                continue
+            rel = os.path.relpath(path, root).replace(os.sep, '/').split('/')
+            if len(rel) < 3:
+                continue
+            key = (rel[0], rel[1].split('.')[0])
+            stage = 'vertex' if re.search(r'\bgl_Position\b', text) else 'fragment'
+            shaders.setdefault(key, []).append((stage, '/'.join(rel[2:]), path))
+
+    pairs = []
+    skipped = set()
+    for (variant, material), found in sorted(shaders.items()):
+        if material_filter and material_filter not in material:
+            continue
+        vertex = {STAGE_RE.sub('*', rel): path for stage, rel, path in found if stage == 'vertex'}
+        by_dir = {}
+        for stage, rel, path in found:
+            if stage == 'vertex':
+                by_dir.setdefault(os.path.dirname(path), []).append(path)
+        for stage, rel, path in found:
+            if stage != 'fragment':
+                continue
+            scene = scene_of(material, rel)
+            if scene is None:
+                skipped.add(material)
+                continue
+            vs = vertex.get(STAGE_RE.sub('*', rel))
+            if vs is None and len(by_dir.get(os.path.dirname(path), [])) == 1:
+                vs = by_dir[os.path.dirname(path)][0]
+            if vs is None:
+                print('Warning: no vertex shader for %s/%s/%s' % (variant, material, rel))
+                continue
+            pairs.append((variant, material, rel, scene, vs, path))
+    return pairs, sorted(skipped)
+
+
+def run(runner, pairs, args):
+    cmd = [runner, '-w', str(args.width), '-h', str(args.height), '-m', str(args.min_ms)]
+    if args.state:
+        cmd += ['-e', args.state]
+    jobs = ''.join('%s\t%s\t%s\n' % (scene, vs, fs) for _, _, _, scene, vs, fs in pairs)
+    proc = subprocess.run(cmd, input=jobs, stdout=subprocess.PIPE, universal_newlines=True)
+    lines = proc.stdout.rstrip('\n').split('\n')
+    if proc.returncode or not lines[0].startswith('states\t'):
+        return None, None
+    states = lines[0].split('\t')[1:]
+
+    rows = []
+    results = lines[1:] + ['error\trunner stopped']*(len(pairs) + 1 - len(lines))
+    for (variant, material, shader, scene, _, _), line in zip(pairs, results):
+        fields = line.split('\t')
+        row = {'variant': variant, 'material': material, 'shader': shader, 'scene': scene}
+        if fields[0] == 'ok':
+            row.update(zip(states, fields[1:]))
+        else:
+            row['error'] = fields[1] if len(fields) > 1 else 'runner stopped'
+        rows.append(row)
+    return states, rows
+
+
+def row_key(row):
+    return '%s|%s|%s' % (row['variant'], row['material'], row['shader'])
+
+
+def write_table(rows, states, path):
+    with open(path, 'w') as f:
+        f.write('\t'.join(('variant', 'material', 'shader', 'scene') + tuple(states)) + '\n')
+        for r in rows:
+            if 'error' not in r:
+                f.write('\t'.join(str(r[k]) for k in ('variant', 'material', 'shader', 'scene') + tuple(states)) + '\n')
+
+
+def read_table(path):
+    rows = {}
+    with open(path) as f:
+        header = f.readline().rstrip('\n').split('\t')
+        for line in f:
+            row = dict(zip(header, line.rstrip('\n').split('\t')))
+            rows[row_key(row)] = row
+    return rows
+
+
+def print_summary(rows, states):
+    """Slowest permutation per variant and material, frame total per variant."""
+    summary = {}
+    for r in rows:
+        if 'error' in r:
+            continue
+        key = (r['variant'], r['material'])
+        worst = summary.setdefault(key, {'count': 0})
+        worst['count'] += 1
+        for s in states:
+            worst[s] = max(worst.get(s, 0.0), float(r[s]))
+
+    print('%-12s %-14s %5s ' % ('variant', 'material', 'perms') + ' '.join('%10s' % s for s in states))
+    totals = {}
+    for key in sorted(summary):
+        r = summary[key]
+        print('%-12s %-14s %5d ' % (key + (r['count'],)) + ' '.join('%10.2f' % r[s] for s in states))
+        total = totals.setdefault(key[0], dict.fromkeys(states, 0.0))
+        for s in states:
+            total[s] += r[s]
+    print('')
+    for variant in sorted(totals):
+        print('%-12s %-14s %5s ' % (variant, '(frame)', '') + ' '.join('%10.2f' % totals[variant][s] for s in states))
+
+
+def diff(rows, baseline, states, threshold, material_filter=None):
+    """Compares the frame time summed over all states of every permutation, single states are too noisy."""
+    regressions = 0
+    current = {row_key(r): r for r in rows if 'error' not in r}
+    for key in sorted(current):
+        r = current[key]
+        base = baseline.get(key)
+        if base is None:
+            print('  new      %s' % key.replace('|', ' '))
+            continue
+        common = [s for s in states if s in base]
+        old = sum(float(base[s]) for s in common)
+        new = sum(float(r[s]) for s in common)
+        if old < MIN_MS and new < MIN_MS:
+            continue
+        pct = 100.0 * (new - old) / old if old else 100.0
+        if abs(pct) > threshold:
+            print('  changed  %s: %.2f->%.2f ms (%+.1f%%)' % (key.replace('|', ' '), old, new, pct))
+            if pct > 0:
+                regressions += 1
+    for key in sorted(set(baseline) - set(current)):
+        if material_filter is None or material_filter in baseline[key]['material']:
+            print('  removed  %s' % key.replace('|', ' '))
+    return regressions
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.split('\n')[0])
+    parser.add_argument('dir', help='unpacked materials, laid out as <variant>/<material>/...')
+    parser.add_argument('-r', dest='runner', default='build/gles/frame', help='frame runner (default build/gles/frame)')
+    parser.add_argument('-o', dest='out', help='write the full table (tsv)')
+    parser.add_argument('-b', dest='baseline', help='diff against a saved table')
+    parser.add_argument('-t', dest='threshold', type=float, default=10.0,
+                        help='fail when a frame time grows by more than this percentage (default 10)')
+    parser.add_argument('-e', dest='state', help='only one scene state (eg. night)')
+    parser.add_argument('-f', dest='filter', help='only materials whose name contains this')
+    parser.add_argument('-s', dest='size', default='1280x720', help='framebuffer size (default 1280x720)')
+    parser.add_argument('-m', dest='min_ms', type=float, default=100.0,
+                        help='time every state for at least this long, best of 3 (default 100)')
+    args = parser.parse_args()
+
+    m = re.match(r'(\d+)x(\d+)$', args.size)
+    if not m:
+        print('Error: bad size %s, expected <width>x<height>' % args.size)
+        return 1
+    args.width, args.height = int(m.group(1)), int(m.group(2))
+
+    pairs, skipped = collect(args.dir, args.filter)
+    if not pairs:
+        print('Error: no GLSL shader pairs found in %s' % args.dir)
+        return 1
+    if skipped:
+        print('no scene for %s, skipped' % ', '.join(skipped))
+
+    states, rows = run(args.runner, pairs, args)
+    if rows is None:
+        print('Error: %s failed' % args.runner)
+        return 1
+
+    print_summary(rows, states)
+
+    errors = [r for r in rows if 'error' in r]
+    for r in errors:
+        print('  error    %s %s %s: %s' % (r['variant'], r['material'], r['shader'], r['error']))
+
+    if args.out:
+        write_table(rows, states, args.out)
+
+    if args.baseline:
+        print('\n>> Diff against %s (threshold %.1f%%)' % (args.baseline, args.threshold))
+        regressions = diff(rows, read_table(args.baseline), states, args.threshold, args.filter)
+        if regressions:
+            print('>> %d frame time(s) over threshold' % regressions)
+            return 2
+        print('>> No regressions')
+    return 2 if errors else 0
+
+
+if __name__ == '__main__':
+    sys.exit(main())
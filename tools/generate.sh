@@ -0,0 +1,32 @@
+#!/bin/bash
+
+# usage: tools/generate.sh <include dir>
+# writes the headers that config.h of <include dir> needs into its newb/functions/,
+# they are generated from the config and never kept in the source tree:
+# - color_fit.h: NL_TONEMAP_FIT curves of the default config and every subpack (tools/color_fit.py)
+# - block_atlas.h: NL_EXTRA_PLANTS_WAVE atlas tables (tools/block_atlas.py)
+# <include dir> is a copy of include/ (pack.sh, build.sh and bench.sh make one)
+
+ATLAS_FILE="tools/atlas/1.20.40.txt" # texture atlas description of NL_EXTRA_PLANTS_WAVE
+
+INCLUDE_DIR=${1%/}
+CONFIG_FILE=$INCLUDE_DIR/newb/config.h
+if [ ! -f "$CONFIG_FILE" ]; then
+  echo "Error: $CONFIG_FILE not found"
+  exit 1
+fi
+source $INCLUDE_DIR/newb/pack_config.sh
+
+ERRORS=0
+if grep -q "^\s*#define NL_TONEMAP_FIT" $CONFIG_FILE; then
+  # refits only when the stamp in the header differs from config.h
+  echo ">> Fitting color correction curves"
+  python3 tools/color_fit.py $CONFIG_FILE ${SUBPACK_OPTIONS[@]} -o $INCLUDE_DIR/newb/functions/color_fit.h || ERRORS=$((ERRORS+1))
+fi
+
+if grep -q "^\s*#define NL_EXTRA_PLANTS_WAVE" $CONFIG_FILE; then
+  echo ">> Generating texture atlas tables"
+  python3 tools/block_atlas.py $ATLAS_FILE -o $INCLUDE_DIR/newb/functions/block_atlas.h || ERRORS=$((ERRORS+1))
+fi
+
+exit $ERRORS
@@ -0,0 +1,829 @@
+/* Offscreen frame time of compiled GLSL/ESSL material shaders.
+ *
+ * usage: frame [-w width] [-h height] [-m min_ms] [-e state]
+ *   -w, -h  framebuffer size in pixels (default 1280x720)
+ *   -m      time each state for at least this long, best of 3 (default 100)
+ *   -e      only run one scene state (day, dusk, night, rain, nether, end, underwater)
+ *
+ * Renders with OpenGL ES 3 on a surfaceless EGL display, which Mesa serves
+ * with llvmpipe when there is no GPU (or with LIBGL_ALWAYS_SOFTWARE=1), so
+ * the numbers only depend on the CPU. Jobs are read from stdin, one per
+ * line, tab separated:
+ *   <scene> <vertex shader> <fragment shader>
+ * scene is one of terrain, water, sky, clouds. For every job one line is
+ * printed: "ok" and the ms per frame of each scene state, or "error" and the
+ * reason. The first line names the states.
+ *
+ * A frame clears the framebuffer, draws the scene mesh once and waits for
+ * glFinish. Uniforms the shaders declare are set from the scene state when
+ * their name is known (bgfx predefined uniforms, FogColor,
+ * FogAndDistanceControl, ViewPositionAndTime ...), others are zero (mat4:
+ * identity). Samplers get small procedural textures.
+ */
+
+#include <EGL/egl.h>
+#include <EGL/eglext.h>
+#include <GLES3/gl3.h>
+
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+// uniform state of one frame, same values as kSceneStates in tools/cpu/scene.h
+struct SceneState {
+  const char *name;
+  float fogColor[3];
+  float fogControl[3]; // FogAndDistanceControl.xyz
+};
+
+static const SceneState kSceneStates[] = {
+  {"day", {0.66f, 0.82f, 1.0f}, {0.604f, 1.0f, 192.0f}},
+  {"dusk", {0.85f, 0.47f, 0.28f}, {0.604f, 1.0f, 192.0f}},
+  {"night", {0.02f, 0.03f, 0.06f}, {0.604f, 1.0f, 192.0f}},
+  {"rain", {0.31f, 0.34f, 0.39f}, {0.23f, 0.70f, 192.0f}},
+  {"nether", {0.33f, 0.04f, 0.02f}, {0.05f, 0.5f, 192.0f}},
+  {"end", {0.45f, 0.0f, 0.45f}, {0.3f, 1.0f, 192.0f}},
+  {"underwater", {0.02f, 0.16f, 0.35f}, {0.0f, 0.6f, 192.0f}},
+};
+static const int kSceneStateCount = sizeof(kSceneStates)/sizeof(kSceneStates[0]);
+
+// ViewPositionAndTime.w, 20 minutes in
+static const float kTime = 1200.0f;
+
+// column major 4x4
+struct Mat4 {
+  float m[16];
+
+  static Mat4 identity() {
+    Mat4 r = {};
+    r.m[0] = r.m[5] = r.m[10] = r.m[15] = 1.0f;
+    return r;
+  }
+  static Mat4 translate(float x, float y, float z) {
+    Mat4 r = identity();
+    r.m[12] = x;
+    r.m[13] = y;
+    r.m[14] = z;
+    return r;
+  }
+  static Mat4 scale(float x, float y, float z) {
+    Mat4 r = identity();
+    r.m[0] = x;
+    r.m[5] = y;
+    r.m[10] = z;
+    return r;
+  }
+  static Mat4 rotateX(float a) {
+    Mat4 r = identity();
+    r.m[5] = cosf(a);
+    r.m[6] = sinf(a);
+    r.m[9] = -sinf(a);
+    r.m[10] = cosf(a);
+    return r;
+  }
+  static Mat4 perspective(float fovy, float aspect, float near, float far) {
+    Mat4 r = {};
+    float f = 1.0f/tanf(0.5f*fovy);
+    r.m[0] = f/aspect;
+    r.m[5] = f;
+    r.m[10] = (far + near)/(near - far);
+    r.m[11] = -1.0f;
+    r.m[14] = 2.0f*far*near/(near - far);
+    return r;
+  }
+
+  Mat4 operator*(const Mat4 &b) const {
+    Mat4 r;
+    for (int c = 0; c < 4; c++) {
+      for (int i = 0; i < 4; i++) {
+        float s = 0.0f;
+        for (int k = 0; k < 4; k++) {
+          s += m[4*k + i]*b.m[4*c + k];
+        }
+        r.m[4*c + i] = s;
+      }
+    }
+    return r;
+  }
+};
+
+struct Vertex {
+  float position[3];
+  float color[4];
+  float uv0[2];
+  float uv1[2];
+};
+
+struct Draw {
+  int first;
+  int count;
+  Mat4 model;
+};
+
+struct Mesh {
+  std::vector<Vertex> vertices;
+  std::vector<GLuint> indices;
+  std::vector<Draw> draws;
+  bool depthTest;
+  bool blend;
+
+  void quad(const float p[4][3], const float color[4], const float uv[4][2], const float uv1[2]) {
+    GLuint base = GLuint(vertices.size());
+    for (int i = 0; i < 4; i++) {
+      Vertex v = {{p[i][0], p[i][1], p[i][2]}, {color[0], color[1], color[2], color[3]}, {uv[i][0], uv[i][1]}, {uv1[0], uv1[1]}};
+      vertices.push_back(v);
+    }
+    const GLuint tris[6] = {0, 1, 2, 0, 2, 3};
+    for (GLuint i : tris) {
+      indices.push_back(base + i);
+    }
+  }
+};
+
+static unsigned hash2(int x, int z) {
+  unsigned h = unsigned(x)*73856093u ^ unsigned(z)*19349663u;
+  h ^= h >> 13;
+  h *= 0x5bd1e995u;
+  return h ^ (h >> 15);
+}
+
+// atlas tile (64x32 tiles of the raw uv0) corners
+static void tileUv(int tile, float uv[4][2]) {
+  float u = float(tile % 64)/64.0f;
+  float v = float(tile/64)/32.0f;
+  const float du = 1.0f/64.0f;
+  const float dv = 1.0f/32.0f;
+  float corners[4][2] = {{u, v + dv}, {u + du, v + dv}, {u + du, v}, {u, v}};
+  memcpy(uv, corners, sizeof(corners));
+}
+
+// camera sits at the origin, chunks are drawn at their offset to it
+static const float kCameraY = 71.62f;
+static const int kChunkRadius = 6; // 12x12 chunks, 192 blocks across
+
+static int terrainHeight(int x, int z) {
+  return 64 + int(floorf(4.0f*sinf(0.11f*x) + 3.0f*cosf(0.07f*z) + 2.0f*sinf(0.05f*float(x + z))));
+}
+
+// 16x16 block columns per chunk: top faces and exposed sides, one quad per block face
+static Mesh terrainMesh() {
+  Mesh mesh;
+  mesh.depthTest = true;
+  mesh.blend = false;
+  const float chunkY = 56.0f;
+  for (int cx = -kChunkRadius; cx < kChunkRadius; cx++) {
+    for (int cz = -kChunkRadius; cz < kChunkRadius; cz++) {
+      int first = int(mesh.indices.size());
+      for (int bx = 0; bx < 16; bx++) {
+        for (int bz = 0; bz < 16; bz++) {
+          int x = 16*cx + bx;
+          int z = 16*cz + bz;
+          int h = terrainHeight(x, z);
+          unsigned r = hash2(x, z);
+          float top = float(h + 1) - chunkY;
+          float lx = float(bx);
+          float lz = float(bz);
+
+          // grass tinted tops, stone and dirt sides, a torch lit patch around the camera
+          float torch = fmaxf(0.0f, 1.0f - sqrtf(float(x*x + z*z))/14.0f)*0.9f;
+          bool grass = (r & 3u) != 0u;
+          float tint[4] = {0.47f, 0.74f, 0.33f, 1.0f};
+          float white[4] = {1.0f, 1.0f, 1.0f, 1.0f};
+          float uv[4][2];
+          tileUv(int(r >> 8) % 2048, uv);
+          float uv1Top[2] = {torch, 1.0f};
+          float pTop[4][3] = {{lx, top, lz + 1.0f}, {lx + 1.0f, top, lz + 1.0f}, {lx + 1.0f, top, lz}, {lx, top, lz}};
+          mesh.quad(pTop, grass ? tint : white, uv, uv1Top);
+
+          const int dirs[4][2] = {{1, 0}, {-1, 0}, {0, 1}, {0, -1}};
+          for (int d = 0; d < 4; d++) {
+            int nh = terrainHeight(x + dirs[d][0], z + dirs[d][1]);
+            float shade = dirs[d][0] != 0 ? 0.6f : 0.8f;
+            float side[4] = {shade, shade, shade, 1.0f};
+            float uv1Side[2] = {torch, 0.85f};
+            for (int y = nh + 1; y <= h; y++) {
+              float y0 = float(y) - chunkY;
+              float y1 = y0 + 1.0f;
+              float ox = dirs[d][0] > 0 ? lx + 1.0f : lx;
+              float oz = dirs[d][1] > 0 ? lz + 1.0f : lz;
+              float p[4][3];
+              if (dirs[d][0] != 0) {
+                float q[4][3] = {{ox, y0, lz}, {ox, y0, lz + 1.0f}, {ox, y1, lz + 1.0f}, {ox, y1, lz}};
+                memcpy(p, q, sizeof(q));
+              } else {
+                float q[4][3] = {{lx, y0, oz}, {lx + 1.0f, y0, oz}, {lx + 1.0f, y1, oz}, {lx, y1, oz}};
+                memcpy(p, q, sizeof(q));
+              }
+              tileUv(int(hash2(x, y + 1000*d) >> 8) % 2048, uv);
+              mesh.quad(p, side, uv, uv1Side);
+            }
+          }
+        }
+      }
+      Draw draw = {first, int(mesh.indices.size()) - first, Mat4::translate(16.0f*cx, chunkY - kCameraY, 16.0f*cz)};
+      mesh.draws.push_back(draw);
+    }
+  }
+  return mesh;
+}
+
+// still water, block tops at 0.875 of sea level 62, over the whole terrain area
+static Mesh waterMesh() {
+  Mesh mesh;
+  mesh.depthTest = true;
+  mesh.blend = true;
+  const float chunkY = 56.0f;
+  const float top = 62.875f - chunkY;
+  float color[4] = {0.25f, 0.45f, 0.9f, 0.65f};
+  float uv1[2] = {0.0f, 1.0f};
+  for (int cx = -kChunkRadius; cx < kChunkRadius; cx++) {
+    for (int cz = -kChunkRadius; cz < kChunkRadius; cz++) {
+      int first = int(mesh.indices.size());
+      for (int bx = 0; bx < 16; bx++) {
+        for (int bz = 0; bz < 16; bz++) {
+          float lx = float(bx);
+          float lz = float(bz);
+          float p[4][3] = {{lx, top, lz + 1.0f}, {lx + 1.0f, top, lz + 1.0f}, {lx + 1.0f, top, lz}, {lx, top, lz}};
+          float uv[4][2];
+          tileUv(1800, uv);
+          mesh.quad(p, color, uv, uv1);
+        }
+      }
+      Draw draw = {first, int(mesh.indices.size()) - first, Mat4::translate(16.0f*cx, chunkY - kCameraY, 16.0f*cz)};
+      mesh.draws.push_back(draw);
+    }
+  }
+  return mesh;
+}
+
+// unit sphere around the camera, a_color0.r is 0 at the zenith and 1 at the horizon
+static Mesh skyMesh() {
+  Mesh mesh;
+  mesh.depthTest = false;
+  mesh.blend = true;
+  const int rings = 16;
+  const int segments = 32;
+  const float pi = 3.14159265f;
+  float uv1[2] = {0.0f, 1.0f};
+  for (int i = 0; i < rings; i++) {
+    for (int j = 0; j < segments; j++) {
+      float p[4][3];
+      float uv[4][2];
+      float edge[4];
+      const int corners[4][2] = {{i, j}, {i, j + 1}, {i + 1, j + 1}, {i + 1, j}};
+      for (int k = 0; k < 4; k++) {
+        float a = pi*float(corners[k][0])/float(rings);
+        float b = 2.0f*pi*float(corners[k][1])/float(segments);
+        p[k][0] = sinf(a)*cosf(b);
+        p[k][1] = cosf(a);
+        p[k][2] = sinf(a)*sinf(b);
+        uv[k][0] = float(corners[k][1])/float(segments);
+        uv[k][1] = float(corners[k][0])/float(rings);
+        edge[k] = 1.0f - fabsf(p[k][1]);
+      }
+      float color[4] = {0.5f*(edge[0] + edge[2]), 0.5f*(edge[0] + edge[2]), 0.5f*(edge[0] + edge[2]), 1.0f};
+      mesh.quad(p, color, uv, uv1);
+    }
+  }
+  Draw draw = {0, int(mesh.indices.size()), Mat4::identity()};
+  mesh.draws.push_back(draw);
+  return mesh;
+}
+
+// vanilla cloud grid: 64x64 cells, bottom and top plane, scaled to 768 blocks
+static Mesh cloudMesh() {
+  Mesh mesh;
+  mesh.depthTest = true;
+  mesh.blend = true;
+  float color[4] = {1.0f, 1.0f, 1.0f, 1.0f};
+  float uv[4][2] = {{0.0f, 0.0f}, {1.0f, 0.0f}, {1.0f, 1.0f}, {0.0f, 1.0f}};
+  float uv1[2] = {0.0f, 1.0f};
+  for (int y = 0; y < 2; y++) {
+    for (int x = 0; x < 64; x++) {
+      for (int z = 0; z < 64; z++) {
+        float fx = float(x);
+        float fz = float(z);
+        float fy = float(y);
+        float p[4][3] = {{fx, fy, fz}, {fx + 1.0f, fy, fz}, {fx + 1.0f, fy, fz + 1.0f}, {fx, fy, fz + 1.0f}};
+        mesh.quad(p, color, uv, uv1);
+      }
+    }
+  }
+  Draw draw = {0, int(mesh.indices.size()), Mat4::translate(0.0f, 40.0f, 0.0f)*Mat4::scale(12.0f, 1.0f, 12.0f)};
+  mesh.draws.push_back(draw);
+  return mesh;
+}
+
+static GLuint makeTexture(int w, int h, const std::vector<unsigned char> &rgba) {
+  GLuint tex;
+  glGenTextures(1, &tex);
+  glBindTexture(GL_TEXTURE_2D, tex);
+  glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, w, h, 0, GL_RGBA, GL_UNSIGNED_BYTE, rgba.data());
+  glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+  glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+  glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
+  glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
+  return tex;
+}
+
+struct Textures {
+  GLuint atlas;    // s_MatTexture: 16px noise tiles, some cut out, a few glowing (alpha 252)
+  GLuint lightMap; // s_LightMapTexture: block light x, sky light y
+  GLuint gray;     // any other sampler2D
+  GLuint cube;     // samplerCube
+
+  void create() {
+    std::vector<unsigned char> px(1024*512*4);
+    for (int y = 0; y < 512; y++) {
+      for (int x = 0; x < 1024; x++) {
+        unsigned t = hash2(x/16, y/16);
+        unsigned n = hash2(x, y);
+        unsigned char *p = &px[4*(1024*y + x)];
+        p[0] = (unsigned char)(((t >> 0) & 127u) + (n & 63u));
+        p[1] = (unsigned char)(((t >> 7) & 127u) + ((n >> 6) & 63u));
+        p[2] = (unsigned char)(((t >> 14) & 127u) + ((n >> 12) & 63u));
+        p[3] = (t & 0x300u) == 0u ? ((n & 0x300u) == 0u ? 0 : 255) : ((t & 0xf000u) == 0u ? 252 : 255);
+      }
+    }
+    atlas = makeTexture(1024, 512, px);
+
+    px.assign(16*16*4, 255);
+    for (int y = 0; y < 16; y++) {
+      for (int x = 0; x < 16; x++) {
+        unsigned char *p = &px[4*(16*y + x)];
+        float block = float(x)/15.0f;
+        float sky = float(y)/15.0f;
+        p[0] = (unsigned char)(255.0f*fminf(1.0f, 0.05f + 0.95f*fmaxf(block, sky)));
+        p[1] = (unsigned char)(255.0f*fminf(1.0f, 0.05f + 0.85f*fmaxf(block, sky)));
+        p[2] = (unsigned char)(255.0f*fminf(1.0f, 0.05f + 0.95f*fmaxf(0.6f*block, sky)));
+      }
+    }
+    lightMap = makeTexture(16, 16, px);
+    glBindTexture(GL_TEXTURE_2D, lightMap);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+
+    px.assign(64*64*4, 160);
+    gray = makeTexture(64, 64, px);
+
+    glGenTextures(1, &cube);
+    glBindTexture(GL_TEXTURE_CUBE_MAP, cube);
+    for (int face = 0; face < 6; face++) {
+      glTexImage2D(GL_TEXTURE_CUBE_MAP_POSITIVE_X + face, 0, GL_RGBA, 64, 64, 0, GL_RGBA, GL_UNSIGNED_BYTE, px.data());
+    }
+    glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+  }
+};
+
+static bool readFile(const std::string &path, std::string &text) {
+  std::ifstream f(path, std::ios::binary);
+  if (!f) {
+    return false;
+  }
+  std::stringstream ss;
+  ss << f.rdbuf();
+  text = ss.str();
+  return true;
+}
+
+static std::string firstLine(const std::string &log) {
+  std::string line = log.substr(0, log.find('\n'));
+  return line.empty() ? "no info log" : line;
+}
+
+static GLuint compile(GLenum stage, const std::string &src, std::string &error) {
+  GLuint shader = glCreateShader(stage);
+  const char *text = src.c_str();
+  glShaderSource(shader, 1, &text, nullptr);
+  glCompileShader(shader);
+  GLint ok = 0;
+  glGetShaderiv(shader, GL_COMPILE_STATUS, &ok);
+  if (!ok) {
+    char log[1024] = {};
+    glGetShaderInfoLog(shader, sizeof(log), nullptr, log);
+    error = std::string(stage == GL_VERTEX_SHADER ? "vertex: " : "fragment: ") + firstLine(log);
+    glDeleteShader(shader);
+    return 0;
+  }
+  return shader;
+}
+
+static GLuint link(const std::string &vsPath, const std::string &fsPath, std::string &error) {
+  std::string vsText, fsText;
+  if (!readFile(vsPath, vsText) || !readFile(fsPath, fsText)) {
+    error = "cannot read shaders";
+    return 0;
+  }
+  GLuint vs = compile(GL_VERTEX_SHADER, vsText, error);
+  GLuint fs = vs ? compile(GL_FRAGMENT_SHADER, fsText, error) : 0;
+  if (!fs) {
+    glDeleteShader(vs);
+    return 0;
+  }
+  GLuint program = glCreateProgram();
+  glAttachShader(program, vs);
+  glAttachShader(program, fs);
+  glLinkProgram(program);
+  glDeleteShader(vs);
+  glDeleteShader(fs);
+  GLint ok = 0;
+  glGetProgramiv(program, GL_LINK_STATUS, &ok);
+  if (!ok) {
+    char log[1024] = {};
+    glGetProgramInfoLog(program, sizeof(log), nullptr, log);
+    error = "link: " + firstLine(log);
+    glDeleteProgram(program);
+    return 0;
+  }
+  return program;
+}
+
+struct Uniform {
+  std::string name;
+  GLint location;
+  GLenum type;
+};
+
+// per frame values of the uniforms the game sets, by name
+static bool frameUniform(const std::string &name, const SceneState &state, float *v) {
+  const float *fog = state.fogColor;
+  const float *ctl = state.fogControl;
+  if (name == "FogColor") {
+    float r[4] = {fog[0], fog[1], fog[2], 1.0f};
+    memcpy(v, r, sizeof(r));
+  } else if (name == "FogAndDistanceControl" || name == "FogControl") {
+    float r[4] = {ctl[0], ctl[1], ctl[2], ctl[2]};
+    memcpy(v, r, sizeof(r));
+  } else if (name == "ViewPositionAndTime") {
+    float r[4] = {0.0f, 0.0f, 0.0f, kTime};
+    memcpy(v, r, sizeof(r));
+  } else if (name == "SkyColor" || name == "CloudColor") {
+    float r[4] = {fog[0], fog[1], fog[2], 0.8f};
+    memcpy(v, r, sizeof(r));
+  } else if (name == "SunMoonColor" || name == "TileLightColor" || name == "MatColor" || name == "HudOpacity" ||
+             name == "MultiplicativeTintColor" || name == "ColorBased" || name == "LightDiffuseColorAndIlluminance" ||
+             name == "LightDiffuseColorAndIntensity") {
+    float r[4] = {1.0f, 1.0f, 1.0f, 1.0f};
+    memcpy(v, r, sizeof(r));
+  } else if (name == "LightWorldSpaceDirection") {
+    float r[4] = {0.0f, 1.0f, 0.0f, 0.0f};
+    memcpy(v, r, sizeof(r));
+  } else if (name == "UVAnimation") {
+    float r[4] = {0.0f, 0.0f, 1.0f, 1.0f};
+    memcpy(v, r, sizeof(r));
+  } else {
+    return false;
+  }
+  return true;
+}
+
+struct Bench {
+  int width = 1280;
+  int height = 720;
+  double minMs = 100.0;
+  Mat4 view;
+  Mat4 proj;
+  Textures textures;
+  Mesh meshes[4];
+  GLuint vbo[4];
+  GLuint ibo[4];
+
+  void init() {
+    // level camera: terrain and water below the horizon, sky and clouds above
+    view = Mat4::identity();
+    proj = Mat4::perspective(70.0f*3.14159265f/180.0f, float(width)/float(height), 0.1f, 1024.0f);
+
+    GLuint fbo, color, depth;
+    glGenFramebuffers(1, &fbo);
+    glBindFramebuffer(GL_FRAMEBUFFER, fbo);
+    glGenRenderbuffers(1, &color);
+    glBindRenderbuffer(GL_RENDERBUFFER, color);
+    glRenderbufferStorage(GL_RENDERBUFFER, GL_RGBA8, width, height);
+    glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_RENDERBUFFER, color);
+    glGenRenderbuffers(1, &depth);
+    glBindRenderbuffer(GL_RENDERBUFFER, depth);
+    glRenderbufferStorage(GL_RENDERBUFFER, GL_DEPTH_COMPONENT24, width, height);
+    glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, GL_RENDERBUFFER, depth);
+    glViewport(0, 0, width, height);
+
+    textures.create();
+
+    meshes[0] = terrainMesh();
+    meshes[1] = waterMesh();
+    meshes[2] = skyMesh();
+    meshes[3] = cloudMesh();
+    glGenBuffers(4, vbo);
+    glGenBuffers(4, ibo);
+    for (int i = 0; i < 4; i++) {
+      glBindBuffer(GL_ARRAY_BUFFER, vbo[i]);
+      glBufferData(GL_ARRAY_BUFFER, meshes[i].vertices.size()*sizeof(Vertex), meshes[i].vertices.data(), GL_STATIC_DRAW);
+      glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, ibo[i]);
+      glBufferData(GL_ELEMENT_ARRAY_BUFFER, meshes[i].indices.size()*sizeof(GLuint), meshes[i].indices.data(), GL_STATIC_DRAW);
+    }
+  }
+
+  int sceneIndex(const std::string &scene) {
+    const char *names[4] = {"terrain", "water", "sky", "clouds"};
+    for (int i = 0; i < 4; i++) {
+      if (scene == names[i]) {
+        return i;
+      }
+    }
+    return -1;
+  }
+
+  // binds attributes by bgfx name; instance data and unknown inputs are constant
+  GLuint vertexArray(GLuint program, int scene, std::vector<GLint> &instanceData) {
+    GLuint vao;
+    glGenVertexArrays(1, &vao);
+    glBindVertexArray(vao);
+    glBindBuffer(GL_ARRAY_BUFFER, vbo[scene]);
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, ibo[scene]);
+
+    GLint count = 0;
+    glGetProgramiv(program, GL_ACTIVE_ATTRIBUTES, &count);
+    instanceData.assign(4, -1);
+    for (GLint i = 0; i < count; i++) {
+      char name[128];
+      GLint size;
+      GLenum type;
+      glGetActiveAttrib(program, GLuint(i), sizeof(name), nullptr, &size, &type, name);
+      GLint loc = glGetAttribLocation(program, name);
+      if (loc < 0) {
+        continue;
+      }
+      std::string n = name;
+      if (n == "a_position") {
+        glVertexAttribPointer(loc, 3, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void *)offsetof(Vertex, position));
+      } else if (n == "a_color0") {
+        glVertexAttribPointer(loc, 4, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void *)offsetof(Vertex, color));
+      } else if (n == "a_texcoord0") {
+        glVertexAttribPointer(loc, 2, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void *)offsetof(Vertex, uv0));
+      } else if (n == "a_texcoord1") {
+        glVertexAttribPointer(loc, 2, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void *)offsetof(Vertex, uv1));
+      } else {
+        if (n.size() == 7 && n.compare(0, 6, "i_data") == 0 && n[6] >= '0' && n[6] <= '3') {
+          instanceData[n[6] - '0'] = loc;
+        }
+        glVertexAttrib4f(loc, 0.0f, 0.0f, 0.0f, 1.0f);
+        continue;
+      }
+      glEnableVertexAttribArray(loc);
+    }
+    return vao;
+  }
+
+  std::vector<Uniform> uniforms(GLuint program) {
+    std::vector<Uniform> list;
+    GLint count = 0;
+    glGetProgramiv(program, GL_ACTIVE_UNIFORMS, &count);
+    for (GLint i = 0; i < count; i++) {
+      char name[128];
+      GLint size;
+      GLenum type;
+      glGetActiveUniform(program, GLuint(i), sizeof(name), nullptr, &size, &type, name);
+      Uniform u = {name, glGetUniformLocation(program, name), type};
+      size_t bracket = u.name.find('[');
+      if (bracket != std::string::npos) {
+        u.name = u.name.substr(0, bracket);
+      }
+      if (u.location >= 0) {
+        list.push_back(u);
+      }
+    }
+    return list;
+  }
+
+  // samplers and values that stay the same for the whole job
+  void setConstants(const std::vector<Uniform> &list) {
+    int unit = 0;
+    float zero[16] = {};
+    for (const Uniform &u : list) {
+      if (u.type == GL_SAMPLER_2D) {
+        glActiveTexture(GL_TEXTURE0 + unit);
+        GLuint tex = u.name == "s_MatTexture" ? textures.atlas : u.name == "s_LightMapTexture" ? textures.lightMap : textures.gray;
+        glBindTexture(GL_TEXTURE_2D, tex);
+        glUniform1i(u.location, unit++);
+      } else if (u.type == GL_SAMPLER_CUBE) {
+        glActiveTexture(GL_TEXTURE0 + unit);
+        glBindTexture(GL_TEXTURE_CUBE_MAP, textures.cube);
+        glUniform1i(u.location, unit++);
+      } else if (u.type == GL_FLOAT_MAT4) {
+        glUniformMatrix4fv(u.location, 1, GL_FALSE, Mat4::identity().m);
+      } else if (u.type == GL_FLOAT_VEC4) {
+        glUniform4fv(u.location, 1, zero);
+      }
+      if (u.name == "u_viewRect") {
+        glUniform4f(u.location, 0.0f, 0.0f, float(width), float(height));
+      } else if (u.name == "u_viewTexel") {
+        glUniform4f(u.location, 1.0f/float(width), 1.0f/float(height), 0.0f, 0.0f);
+      }
+    }
+  }
+
+  void setState(const std::vector<Uniform> &list, const SceneState &state) {
+    for (const Uniform &u : list) {
+      float v[4];
+      if (u.type == GL_FLOAT_VEC4 && frameUniform(u.name, state, v)) {
+        glUniform4fv(u.location, 1, v);
+      }
+    }
+    const Mat4 viewProj = proj*view;
+    for (const Uniform &u : list) {
+      if (u.name == "u_view") {
+        glUniformMatrix4fv(u.location, 1, GL_FALSE, view.m);
+      } else if (u.name == "u_proj") {
+        glUniformMatrix4fv(u.location, 1, GL_FALSE, proj.m);
+      } else if (u.name == "u_viewProj") {
+        glUniformMatrix4fv(u.location, 1, GL_FALSE, viewProj.m);
+      }
+    }
+  }
+
+  void frame(int scene, const std::vector<Uniform> &list, const std::vector<GLint> &instanceData) {
+    const Mesh &mesh = meshes[scene];
+    glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+    const Mat4 viewProj = proj*view;
+    for (const Draw &draw : mesh.draws) {
+      const Mat4 modelView = view*draw.model;
+      const Mat4 modelViewProj = viewProj*draw.model;
+      for (const Uniform &u : list) {
+        if (u.name == "u_model") {
+          glUniformMatrix4fv(u.location, 1, GL_FALSE, draw.model.m);
+        } else if (u.name == "u_modelView") {
+          glUniformMatrix4fv(u.location, 1, GL_FALSE, modelView.m);
+        } else if (u.name == "u_modelViewProj") {
+          glUniformMatrix4fv(u.location, 1, GL_FALSE, modelViewProj.m);
+        }
+      }
+      for (int c = 0; c < 4; c++) {
+        if (instanceData[c] >= 0) {
+          glVertexAttrib4fv(instanceData[c], &draw.model.m[4*c]);
+        }
+      }
+      glDrawElements(GL_TRIANGLES, draw.count, GL_UNSIGNED_INT, (void *)(sizeof(GLuint)*draw.first));
+    }
+    glFinish();
+  }
+
+  // ms per frame, best of 3 runs of at least minMs each
+  double time(int scene, const std::vector<Uniform> &list, const std::vector<GLint> &instanceData) {
+    typedef std::chrono::steady_clock clock;
+    // first frames compile the llvmpipe variants of the program
+    frame(scene, list, instanceData);
+    frame(scene, list, instanceData);
+    double best = 1e30;
+    for (int run = 0; run < 3; run++) {
+      int frames = 0;
+      double ms = 0.0;
+      clock::time_point start = clock::now();
+      while (ms < minMs || frames < 2) {
+        frame(scene, list, instanceData);
+        frames++;
+        ms = std::chrono::duration<double, std::milli>(clock::now() - start).count();
+      }
+      best = ms/frames < best ? ms/frames : best;
+    }
+    return best;
+  }
+
+  std::string run(const std::string &sceneName, const std::string &vs, const std::string &fs, const char *onlyState) {
+    int scene = sceneIndex(sceneName);
+    if (scene < 0) {
+      return "error\tunknown scene " + sceneName;
+    }
+    std::string error;
+    GLuint program = link(vs, fs, error);
+    if (!program) {
+      return "error\t" + error;
+    }
+    glUseProgram(program);
+    std::vector<GLint> instanceData;
+    GLuint vao = vertexArray(program, scene, instanceData);
+    std::vector<Uniform> list = uniforms(program);
+    setConstants(list);
+
+    const Mesh &mesh = meshes[scene];
+    if (mesh.depthTest) {
+      glEnable(GL_DEPTH_TEST);
+      glDepthFunc(GL_LEQUAL);
+    } else {
+      glDisable(GL_DEPTH_TEST);
+    }
+    if (mesh.blend) {
+      glEnable(GL_BLEND);
+      glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+    } else {
+      glDisable(GL_BLEND);
+    }
+
+    std::string line = "ok";
+    for (int i = 0; i < kSceneStateCount; i++) {
+      if (onlyState != nullptr && strcmp(onlyState, kSceneStates[i].name) != 0) {
+        continue;
+      }
+      setState(list, kSceneStates[i]);
+      char ms[32];
+      snprintf(ms, sizeof(ms), "\t%.3f", time(scene, list, instanceData));
+      line += ms;
+    }
+
+    GLenum glError = glGetError();
+    glBindVertexArray(0);
+    glDeleteVertexArrays(1, &vao);
+    glDeleteProgram(program);
+    if (glError != GL_NO_ERROR) {
+      char msg[64];
+      snprintf(msg, sizeof(msg), "error\tGL error 0x%04x", glError);
+      return msg;
+    }
+    return line;
+  }
+};
+
+static bool initContext() {
+  PFNEGLGETPLATFORMDISPLAYEXTPROC getPlatformDisplay =
+    (PFNEGLGETPLATFORMDISPLAYEXTPROC)eglGetProcAddress("eglGetPlatformDisplayEXT");
+  if (getPlatformDisplay == nullptr) {
+    fprintf(stderr, "Error: eglGetPlatformDisplayEXT not available\n");
+    return false;
+  }
+  EGLDisplay display = getPlatformDisplay(EGL_PLATFORM_SURFACELESS_MESA, EGL_DEFAULT_DISPLAY, nullptr);
+  EGLint major, minor;
+  if (display == EGL_NO_DISPLAY || !eglInitialize(display, &major, &minor)) {
+    fprintf(stderr, "Error: no surfaceless EGL display (Mesa EGL_MESA_platform_surfaceless)\n");
+    return false;
+  }
+  eglBindAPI(EGL_OPENGL_ES_API);
+  const EGLint attribs[] = {EGL_CONTEXT_MAJOR_VERSION, 3, EGL_CONTEXT_MINOR_VERSION, 1, EGL_NONE};
+  EGLContext context = eglCreateContext(display, EGL_NO_CONFIG_KHR, EGL_NO_CONTEXT, attribs);
+  if (context == EGL_NO_CONTEXT || !eglMakeCurrent(display, EGL_NO_SURFACE, EGL_NO_SURFACE, context)) {
+    fprintf(stderr, "Error: cannot create an OpenGL ES 3.1 context (0x%04x)\n", eglGetError());
+    return false;
+  }
+  fprintf(stderr, "%s, %s\n", glGetString(GL_RENDERER), glGetString(GL_VERSION));
+  return true;
+}
+
+int main(int argc, char **argv) {
+  Bench bench;
+  const char *onlyState = nullptr;
+
+  for (int i = 1; i < argc; i++) {
+    if (i + 1 < argc && strcmp(argv[i], "-w") == 0) {
+      bench.width = atoi(argv[++i]);
+    } else if (i + 1 < argc && strcmp(argv[i], "-h") == 0) {
+      bench.height = atoi(argv[++i]);
+    } else if (i + 1 < argc && strcmp(argv[i], "-m") == 0) {
+      bench.minMs = atof(argv[++i]);
+    } else if (i + 1 < argc && strcmp(argv[i], "-e") == 0) {
+      onlyState = argv[++i];
+    } else {
+      fprintf(stderr, "Invalid option: %s\n", argv[i]);
+      return 1;
+    }
+  }
+
+  bool known = onlyState == nullptr;
+  std::string header = "states";
+  for (int i = 0; i < kSceneStateCount; i++) {
+    if (onlyState == nullptr || strcmp(onlyState, kSceneStates[i].name) == 0) {
+      header += std::string("\t") + kSceneStates[i].name;
+      known = true;
+    }
+  }
+  if (!known) {
+    fprintf(stderr, "Error: unknown scene state %s\n", onlyState);
+    return 1;
+  }
+
+  if (!initContext()) {
+    return 1;
+  }
+  bench.init();
+
+  printf("%s\n", header.c_str());
+  fflush(stdout);
+  std::string line;
+  while (std::getline(std::cin, line)) {
+    // tab separated, paths may hold spaces
+    std::istringstream job(line);
+    std::string scene, vs, fs;
+    if (!std::getline(job, scene, '\t') || !std::getline(job, vs, '\t') || !std::getline(job, fs)) {
+      continue;
+    }
+    printf("%s\n", bench.run(scene, vs, fs, onlyState).c_str());
+    fflush(stdout);
+  }
+  return 0;
+}
@@ -0,0 +1,289 @@
+#!/usr/bin/env python3
+"""Bake the ore glow leak halo into block textures.
+
+Reads every png under the source directory, evaluates the NL_GLOW_LEAK halo of
+nlGlow (glow.h) for each texel and writes textures where the halo is encoded
+with the same 252/253 alpha values that GLOW_PIXEL detects. With
+NL_GLOW_BAKED, nlGlow then needs no neighbour fetches.
+
+A halo texel can only glow with its own color, so the baker picks, per texel,
+the encoding that minimizes the error of the final linear color at full light:
+    |albedo' - albedo| + NL_GLOW_TEX * |glow' - halo|
+where albedo = rgb^2 (RenderChunk squares diffuse) and halo is the leak result
+averaged over the texel. Only opaque or already glowing texels are changed,
+alpha tested cutouts keep their alpha.
+
+The reported error is measured against the unaveraged leak result on a 4x4
+grid of sub-texel positions, in the same linear units. Halos leaking in from
+neighbouring atlas tiles depend on the atlas layout and are not baked.
+Animated textures are baked per frame (frames are width x width).
+
+With -c, NL_GLOW_LEAK and NL_GLOW_TEX are read from config.h. The textures are
+shared by every subpack, so the default config and every subpack given with -s
+must all define NL_GLOW_BAKED with the same leak, otherwise nothing is baked.
+"""
+
+import argparse
+import os
+import struct
+import sys
+import zlib
+
+from color_fit import resolve_config
+
+PNG_SIGNATURE = b'\x89PNG\r\n\x1a\n'
+
+# glowDetect, k(alpha) = (0.995 - a)/(0.995 - 0.9875)
+GLOW_ALPHAS = (252, 253)
+SUBSAMPLES = 4
+
+# c1..c8 of nlGlow as texel offsets (x, y), y grows with uv.y
+#   c3 c4 c5
+#   c2    c6
+#   c1 c8 c7
+OFFSETS = {
+    'c1': (-1, -1), 'c2': (-1, 0), 'c3': (-1, 1), 'c4': (0, 1),
+    'c5': (1, 1), 'c6': (1, 0), 'c7': (1, -1), 'c8': (0, -1),
+}
+
+
+def glow_factor(a):
+    f = a/255.0
+    if 0.9875 < f < 0.995:
+        return (0.995 - f)/(0.995 - 0.9875)
+    return 0.0
+
+
+def read_png(path):
+    with open(path, 'rb') as f:
+        data = f.read()
+    if data[:8] != PNG_SIGNATURE:
+        raise ValueError('not a png')
+
+    pos = 8
+    idat = b''
+    width = height = 0
+    while pos < len(data):
+        length, kind = struct.unpack('>I4s', data[pos:pos + 8])
+        body = data[pos + 8:pos + 8 + length]
+        pos += 12 + length
+        if kind == b'IHDR':
+            width, height, depth, color, _, _, interlace = struct.unpack('>IIBBBBB', body)
+            if depth != 8 or color != 6 or interlace != 0:
+                raise ValueError('only 8 bit RGBA non-interlaced png is supported')
+        elif kind == b'IDAT':
+            idat += body
+
+    raw = zlib.decompress(idat)
+    stride = width*4
+    pixels = bytearray()
+    prev = bytearray(stride)
+    i = 0
+    for _ in range(height):
+        ftype = raw[i]
+        line = bytearray(raw[i + 1:i + 1 + stride])
+        i += 1 + stride
+        for x in range(stride):
+            a = line[x - 4] if x >= 4 else 0
+            b = prev[x]
+            c = prev[x - 4] if x >= 4 else 0
+            if ftype == 1:
+                line[x] = (line[x] + a) & 255
+            elif ftype == 2:
+                line[x] = (line[x] + b) & 255
+            elif ftype == 3:
+                line[x] = (line[x] + (a + b)//2) & 255
+            elif ftype == 4:
+                p = a + b - c
+                pa, pb, pc = abs(p - a), abs(p - b), abs(p - c)
+                line[x] = (line[x] + (a if pa <= pb and pa <= pc else b if pb <= pc else c)) & 255
+        pixels += line
+        prev = line
+    return width, height, pixels
+
+
+def write_png(path, width, height, pixels):
+    def chunk(kind, body):
+        return struct.pack('>I', len(body)) + kind + body + struct.pack('>I', zlib.crc32(kind + body))
+
+    stride = width*4
+    raw = b''.join(b'\x00' + bytes(pixels[y*stride:(y + 1)*stride]) for y in range(height))
+    with open(path, 'wb') as f:
+        f.write(PNG_SIGNATURE)
+        f.write(chunk(b'IHDR', struct.pack('>IIBBBBB', width, height, 8, 6, 0, 0, 0)))
+        f.write(chunk(b'IDAT', zlib.compress(raw, 9)))
+        f.write(chunk(b'IEND', b''))
+
+
+def leak(c, u, v, amount):
+    """nlGlow leak for one sub-texel position, c maps names to neighbour glow"""
+    mix = lambda a, b, t: [a[i]*(1.0 - t) + b[i]*t for i in range(3)]
+    g = mix(mix(c['c1'], c['c3'], u[1]), mix(c['c7'], c['c5'], u[1]), u[0])
+    for i in range(3):
+        side = max(c['c2'][i]*v[0], c['c4'][i]*u[1], c['c6'][i]*u[0], c['c8'][i]*v[1])
+        g[i] = max(g[i], side)
+        g[i] = ((g[i]*0.7 + 0.2)*g[i] + 0.1)*g[i]*amount
+    return g
+
+
+def bake_frame(pixels, width, top, size, amount, tex):
+    """bakes one size x size frame in place
+    returns (texels changed, error sum, max error, texels, error sum without baking,
+             error sum of the exact per texel mean)"""
+    def texel(x, y):
+        o = ((top + y)*width + x)*4
+        return pixels[o:o + 4]
+
+    # neighbour glow uses the raw texture color, outside the frame is unknown (no glow)
+    src = {}
+    for y in range(size):
+        for x in range(size):
+            r, g, b, a = texel(x, y)
+            k = glow_factor(a)
+            src[(x, y)] = [r/255.0*k, g/255.0*k, b/255.0*k]
+    none = [0.0, 0.0, 0.0]
+
+    changed = 0
+    err_sum = 0.0
+    err_max = 0.0
+    err_plain = 0.0
+    err_floor = 0.0
+    count = 0
+    out = {}
+    for y in range(size):
+        for x in range(size):
+            r, g, b, a = texel(x, y)
+            if a < 252:
+                continue
+            albedo = [(r/255.0)**2, (g/255.0)**2, (b/255.0)**2]
+            center = [albedo[i]*glow_factor(a) for i in range(3)]
+
+            c = {n: src.get((x + d[0], y + d[1]), none) for n, d in OFFSETS.items()}
+            targets = []
+            for sy in range(SUBSAMPLES):
+                for sx in range(SUBSAMPLES):
+                    u = ((sx + 0.5)/SUBSAMPLES, (sy + 0.5)/SUBSAMPLES)
+                    halo = leak(c, u, (1.0 - u[0], 1.0 - u[1]), amount)
+                    targets.append([max(center[i], halo[i]) for i in range(3)])
+            mean = [sum(t[i] for t in targets)/len(targets) for i in range(3)]
+            err_floor += tex*sum(sum(abs(mean[i] - t[i]) for i in range(3)) for t in targets)/len(targets)/3.0
+
+            def error(rgb, alpha):
+                alb = [(q/255.0)**2 for q in rgb]
+                k = glow_factor(alpha)
+                e = sum(abs(alb[i] - albedo[i]) for i in range(3))
+                e_glow = sum(sum(abs(alb[i]*k - t[i]) for i in range(3)) for t in targets)/len(targets)
+                return (e + tex*e_glow)/3.0
+
+            best = ((r, g, b), a)
+            best_err = error(*best)
+            err_plain += best_err
+            if max(mean) > 0.0:
+                for alpha in GLOW_ALPHAS:
+                    k = glow_factor(alpha)
+                    rgb = tuple(min(255, int(round(255.0*min(mean[i]/k, 1.0)**0.5))) for i in range(3))
+                    for cand in ((rgb, alpha), ((r, g, b), alpha)):
+                        e = error(*cand)
+                        if e < best_err:
+                            best, best_err = cand, e
+
+            if best != ((r, g, b), a):
+                out[(x, y)] = best
+                changed += 1
+            err_sum += best_err
+            err_max = max(err_max, best_err)
+            count += 1
+
+    for (x, y), (rgb, alpha) in out.items():
+        o = ((top + y)*width + x)*4
+        pixels[o:o + 4] = bytes(rgb + (alpha,))
+
+    return changed, err_sum, err_max, count, err_plain, err_floor
+
+
+def config_leak(config, subpacks):
+    """(NL_GLOW_LEAK, NL_GLOW_TEX) that every variant of config.h bakes with, None if they differ"""
+    baked = set()
+    for option in ['default'] + subpacks:
+        macros = resolve_config(config, option)
+        if 'NL_GLOW_BAKED' not in macros:
+            print('Error: %s: NL_GLOW_BAKED is not defined for %s, the textures are shared' % (config, option))
+            return None
+        leak = (float(macros.get('NL_GLOW_LEAK') or 0.0), float(macros.get('NL_GLOW_TEX') or 8.0))
+        if baked and leak not in baked:
+            print('Error: %s: %s uses NL_GLOW_LEAK %g, NL_GLOW_TEX %g, the textures are baked for %g, %g'
+                  % ((config, option) + leak + next(iter(baked))))
+            return None
+        baked.add(leak)
+    return baked.pop()
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.split('\n')[0])
+    parser.add_argument('src', help='block texture directory (eg. pack/textures/blocks)')
+    parser.add_argument('out', nargs='?', help='output directory, omit to only measure')
+    parser.add_argument('-l', dest='leak', type=float, default=1.0, help='NL_GLOW_LEAK (default 1.0)')
+    parser.add_argument('-g', dest='tex', type=float, default=8.0, help='NL_GLOW_TEX (default 8.0)')
+    parser.add_argument('-c', dest='config', help='config.h, overrides -l and -g')
+    parser.add_argument('-s', dest='subpacks', nargs='*', default=[], help='subpack options of config.h (with -c)')
+    parser.add_argument('-t', dest='tolerance', type=float,
+                        help='fail without writing when the mean error of a texture exceeds this')
+    parser.add_argument('-v', dest='verbose', action='store_true', help='print every texture')
+    args = parser.parse_args()
+
+    if args.config:
+        leak = config_leak(args.config, args.subpacks)
+        if leak is None:
+            return 1
+        args.leak, args.tex = leak
+
+    total = [0, 0.0, 0.0, 0, 0.0, 0.0]
+    over = 0
+    baked = []
+    for root, _, files in sorted(os.walk(args.src)):
+        for name in sorted(files):
+            if not name.endswith('.png'):
+                continue
+            path = os.path.join(root, name)
+            rel = os.path.relpath(path, args.src)
+            try:
+                width, height, pixels = read_png(path)
+            except (ValueError, zlib.error) as e:
+                print('Error: %s: %s' % (rel, e))
+                return 1
+
+            stats = [0, 0.0, 0.0, 0, 0.0, 0.0]
+            for top in range(0, height - width + 1, width):
+                s = bake_frame(pixels, width, top, width, args.leak, args.tex)
+                stats = [a + b for a, b in zip(stats, s)]
+                stats[2] = max(stats[2] - s[2], s[2])
+            total = [a + b for a, b in zip(total, stats)]
+            total[2] = max(total[2] - stats[2], stats[2])
+
+            mean = stats[1]/stats[3] if stats[3] else 0.0
+            if args.tolerance is not None and mean > args.tolerance:
+                over += 1
+                print('   - %s: mean error %.4f over tolerance' % (rel, mean))
+            elif args.verbose:
+                print('   - %-44s %4d texels  mean %.4f  max %.4f' % (rel, stats[0], mean, stats[2]))
+
+            if args.out:
+                baked.append((os.path.join(args.out, rel), width, height, pixels))
+
+    mean = total[1]/total[3] if total[3] else 0.0
+    plain = total[4]/total[3] if total[3] else 0.0
+    floor = total[5]/total[3] if total[3] else 0.0
+    print('   - baked %d texels, error mean %.4f max %.4f (linear, NL_GLOW_TEX %.1f)'
+          % (total[0], mean, total[2], args.tex))
+    print('     without halo: mean %.4f, exact per texel halo: mean %.4f' % (plain, floor))
+    if over:
+        print('Error: %d textures over tolerance %g, nothing written' % (over, args.tolerance))
+        return 2
+    for out, width, height, pixels in baked:
+        os.makedirs(os.path.dirname(out), exist_ok=True)
+        write_png(out, width, height, pixels)
+    return 0
+
+
+if __name__ == '__main__':
+    sys.exit(main())
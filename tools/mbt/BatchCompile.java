@@ -0,0 +1,201 @@
+import java.io.ByteArrayOutputStream;
+import java.io.File;
+import java.io.OutputStream;
+import java.io.PrintStream;
+import java.lang.management.ManagementFactory;
+import java.lang.reflect.InvocationTargetException;
+import java.lang.reflect.Method;
+import java.nio.file.Files;
+import java.nio.file.Paths;
+import java.util.ArrayList;
+import java.util.List;
+import java.util.concurrent.ExecutorService;
+import java.util.concurrent.Executors;
+import java.util.concurrent.Future;
+import java.util.concurrent.atomic.AtomicInteger;
+import java.util.concurrent.atomic.AtomicLong;
+import java.util.jar.JarFile;
+
+/*
+ * Runs MaterialBinTool once per line of a job list, all in one JVM.
+ * Started by build.sh -b as a single-file source program (java 11+):
+ *
+ *   java -cp MaterialBinTool.jar tools/mbt/BatchCompile.java -j 2 jobs.txt
+ *
+ * Every line of jobs.txt holds the MaterialBinTool arguments of one material.
+ * Jobs run on a pool of -j workers (default 1), each job's output is printed
+ * in one piece when it ends. The index of every finished job is appended to
+ * jobs.txt.done and "all" once every job returned, so build.sh can tell a
+ * finished batch from one that was cut short and what is left to compile.
+ *
+ * MaterialBinTool is called through its main(), which was written for one
+ * call per process. Calls to System.exit are turned into exceptions where
+ * the JVM still allows a SecurityManager (java 11 to 17). Static state it
+ * keeps between calls is not isolated, and threads of its own --threads pool
+ * started by an earlier job print to the console directly when more than
+ * one worker runs. Keep -j 1 unless build.sh -b -v found the batch output
+ * identical to the per-process build.
+ */
+public class BatchCompile {
+  // output of the job running on this thread, inherited by threads the job starts
+  static final InheritableThreadLocal<PrintStream> JOB_OUT = new InheritableThreadLocal<>();
+  // output of the only running job with one worker, for threads started by earlier jobs
+  static volatile PrintStream single;
+  // set once the batch ends, lets its own System.exit through
+  static volatile boolean exiting;
+
+  static PrintStream route(PrintStream console) {
+    return new PrintStream(new OutputStream() {
+      PrintStream target() {
+        PrintStream out = JOB_OUT.get();
+        return out != null ? out : single != null ? single : console;
+      }
+      public void write(int b) {
+        target().write(b);
+      }
+      public void write(byte[] b, int off, int len) {
+        target().write(b, off, len);
+      }
+    }, true);
+  }
+
+  // System.exit of MaterialBinTool, thrown instead of ending the batch
+  static class ExitTrapped extends SecurityException {
+    final int status;
+    ExitTrapped(int status) {
+      super("System.exit(" + status + ")");
+      this.status = status;
+    }
+  }
+
+  @SuppressWarnings("removal")
+  static boolean trapExit() {
+    try {
+      System.setSecurityManager(new SecurityManager() {
+        public void checkExit(int status) {
+          if (!exiting) {
+            throw new ExitTrapped(status);
+          }
+        }
+        public void checkPermission(java.security.Permission perm) {
+        }
+        public void checkPermission(java.security.Permission perm, Object context) {
+        }
+      });
+      return true;
+    } catch (UnsupportedOperationException | SecurityException e) {
+      return false;
+    }
+  }
+
+  static synchronized void markDone(String jobFile, String line) throws java.io.IOException {
+    Files.write(Paths.get(jobFile + ".done"), (line + "\n").getBytes(),
+        java.nio.file.StandardOpenOption.CREATE, java.nio.file.StandardOpenOption.APPEND);
+  }
+
+  public static void main(String[] args) throws Exception {
+    long entered = System.currentTimeMillis();
+    long jvmStart = ManagementFactory.getRuntimeMXBean().getStartTime();
+
+    int workers = 1;
+    String jobFile = null;
+    for (int i = 0; i < args.length; i++) {
+      if (args[i].equals("-j") && i + 1 < args.length) {
+        workers = Math.max(1, Integer.parseInt(args[++i]));
+      } else {
+        jobFile = args[i];
+      }
+    }
+    if (jobFile == null) {
+      System.err.println("usage: BatchCompile [-j workers] jobs.txt");
+      System.exit(1);
+    }
+
+    Files.deleteIfExists(Paths.get(jobFile + ".done"));
+    List<String[]> jobs = new ArrayList<>();
+    for (String line : Files.readAllLines(Paths.get(jobFile))) {
+      line = line.trim();
+      if (!line.isEmpty()) {
+        jobs.add(line.split("\\s+"));
+      }
+    }
+
+    // main class of the MaterialBinTool jar on the class path
+    String jar = System.getProperty("java.class.path").split(File.pathSeparator)[0];
+    String mainClass;
+    try (JarFile f = new JarFile(jar)) {
+      mainClass = f.getManifest().getMainAttributes().getValue("Main-Class");
+    }
+    Method mbtMain = Class.forName(mainClass).getMethod("main", String[].class);
+    long loaded = System.currentTimeMillis();
+
+    PrintStream console = System.out;
+    System.setOut(route(console));
+    System.setErr(route(System.err));
+    if (!trapExit()) {
+      console.println(">> no SecurityManager on this JVM, a System.exit of MaterialBinTool ends the batch");
+    }
+
+    final String doneFile = jobFile;
+    final int poolSize = workers;
+    AtomicInteger failed = new AtomicInteger();
+    AtomicLong jobTime = new AtomicLong();
+    ExecutorService pool = Executors.newFixedThreadPool(workers);
+    List<Future<?>> tasks = new ArrayList<>();
+    for (int i = 0; i < jobs.size(); i++) {
+      final int index = i;
+      final String[] job = jobs.get(i);
+      tasks.add(pool.submit(() -> {
+        ByteArrayOutputStream buf = new ByteArrayOutputStream();
+        PrintStream out = new PrintStream(buf, true);
+        JOB_OUT.set(out);
+        if (poolSize == 1) {
+          single = out;
+        }
+        long start = System.currentTimeMillis();
+        boolean ok = true;
+        try {
+          mbtMain.invoke(null, (Object) job);
+        } catch (InvocationTargetException e) {
+          Throwable cause = e.getCause();
+          if (!(cause instanceof ExitTrapped) || ((ExitTrapped) cause).status != 0) {
+            cause.printStackTrace(out);
+            ok = false;
+          }
+        } catch (Exception e) {
+          e.printStackTrace(out);
+          ok = false;
+        } finally {
+          JOB_OUT.remove();
+          single = null;
+        }
+        long time = System.currentTimeMillis() - start;
+        jobTime.addAndGet(time);
+        synchronized (console) {
+          console.print(buf.toString());
+          console.printf("   (%s: %d ms)%n", job[job.length - 2], time);
+        }
+        if (ok) {
+          markDone(doneFile, Integer.toString(index));
+        } else {
+          failed.incrementAndGet();
+        }
+        return null;
+      }));
+    }
+    for (Future<?> task : tasks) {
+      task.get();
+    }
+    pool.shutdown();
+    long done = System.currentTimeMillis();
+
+    console.printf(">> jvm start-up: %d ms (launch %d ms, loading MaterialBinTool %d ms)%n",
+        loaded - jvmStart, entered - jvmStart, loaded - entered);
+    console.printf(">> compile: %d ms for %d materials on %d workers (%d ms of job time), %d failed%n",
+        done - loaded, jobs.size(), workers, jobTime.get(), failed.get());
+    markDone(jobFile, "all");
+    // ends threads MaterialBinTool left running when its own exit was trapped
+    exiting = true;
+    System.exit(failed.get() > 0 ? 1 : 0);
+  }
+}
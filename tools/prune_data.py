@@ -0,0 +1,228 @@
+#!/usr/bin/env python3
+"""Prune unused pass/flag permutations from a RenderDragonData material.
+
+Copies the data directory of one material (data/<ver>/<platform>/<material>)
+to an output directory and drops every variant that the whitelist does not
+keep, so MaterialBinTool neither compiles nor stores it. The whitelist is a
+json object keyed by material name (see whitelist.json):
+
+    "Actor": {
+        "passes": ["Opaque", "Transparent"],
+        "flags": {"Emissive": ["Off", "Emissive"]}
+    }
+
+A variant is kept when its pass is listed (all passes if "passes" is omitted)
+and the value of every listed flag is allowed. Files that were referenced only
+by dropped variants are not copied. Materials without an entry are copied
+unchanged. Keys starting with _ are ignored.
+
+Prints the variant count and data size before and after.
+
+With -f, the dropped variants get their vanilla shaders back instead:
+src is a compiled material unpacked by MaterialBinTool, the -f directory is
+the unpacked vanilla material.bin of the same RenderDragonData entry, and out
+receives src with every variant the whitelist drops (and every pass it drops
+completely) taken from the vanilla material. The vanilla shader files are
+copied to out/vanilla/. Prints the count of compiled and vanilla variants.
+"""
+
+import argparse
+import json
+import os
+import shutil
+import sys
+
+
+def data_json(src):
+    """(path, parsed) of the json files in src that describe passes"""
+    found = []
+    for root, _, files in os.walk(src):
+        for name in sorted(files):
+            if not name.endswith('.json'):
+                continue
+            path = os.path.join(root, name)
+            try:
+                with open(path) as f:
+                    doc = json.load(f)
+            except (OSError, ValueError):
+                continue
+            if isinstance(doc, dict) and isinstance(doc.get('passes'), list):
+                found.append((path, doc))
+    return found
+
+
+def strings(node):
+    """every string value in a json node"""
+    if isinstance(node, str):
+        yield node
+    elif isinstance(node, dict):
+        for v in node.values():
+            yield from strings(v)
+    elif isinstance(node, list):
+        for v in node:
+            yield from strings(v)
+
+
+def keep_variant(pass_name, variant, rule):
+    passes = rule.get('passes')
+    if passes is not None and pass_name not in passes:
+        return False
+    flags = variant.get('flags') or {}
+    for flag, allowed in rule.get('flags', {}).items():
+        if flag in flags and flags[flag] not in allowed:
+            return False
+    return True
+
+
+def prune(doc, rule):
+    """filters doc in place, returns (variants before, variants after, dropped nodes)"""
+    before = after = 0
+    dropped = []
+    for p in doc['passes']:
+        variants = p.get('variants')
+        if not isinstance(variants, list):
+            continue
+        kept = []
+        for v in variants:
+            if keep_variant(p.get('name'), v, rule):
+                kept.append(v)
+            else:
+                dropped.append(v)
+        before += len(variants)
+        after += len(kept)
+        p['variants'] = kept
+    # passes left without variants go too
+    dropped += [p for p in doc['passes'] if p.get('variants') == []]
+    doc['passes'] = [p for p in doc['passes'] if p.get('variants') != []]
+    return before, after, dropped
+
+
+def variant_key(pass_name, variant):
+    return pass_name, json.dumps(variant.get('flags') or {}, sort_keys=True)
+
+
+def vanilla_node(node, src, out):
+    """node with every string naming a file of src pointing to its copy in out/vanilla"""
+    if isinstance(node, str):
+        f = os.path.join(src, node)
+        if node and os.path.isfile(f):
+            dst = os.path.join(out, 'vanilla', node)
+            os.makedirs(os.path.dirname(dst), exist_ok=True)
+            shutil.copyfile(f, dst)
+            return os.path.join('vanilla', node).replace(os.sep, '/')
+        return node
+    if isinstance(node, dict):
+        return {k: vanilla_node(v, src, out) for k, v in node.items()}
+    if isinstance(node, list):
+        return [vanilla_node(v, src, out) for v in node]
+    return node
+
+
+def fallback(doc, vanilla, rule, src, out):
+    """puts the vanilla variants the rule drops back into doc, returns (compiled, vanilla)"""
+    compiled = {}
+    passes = {}
+    for p in doc['passes']:
+        passes[p.get('name')] = p
+        for v in p.get('variants') or []:
+            compiled[variant_key(p.get('name'), v)] = v
+    merged = []
+    n_compiled = n_vanilla = 0
+    for vp in vanilla['passes']:
+        name = vp.get('name')
+        p = passes.get(name)
+        if p is None:
+            # the whole pass was dropped
+            vp = vanilla_node(vp, src, out)
+            n_vanilla += len(vp.get('variants') or [])
+            merged.append(vp)
+            continue
+        variants = []
+        for v in vp.get('variants') or []:
+            ours = compiled.get(variant_key(name, v))
+            if ours is not None and keep_variant(name, v, rule):
+                variants.append(ours)
+                n_compiled += 1
+            else:
+                variants.append(vanilla_node(v, src, out))
+                n_vanilla += 1
+        p['variants'] = variants
+        merged.append(p)
+    doc['passes'] = merged
+    return n_compiled, n_vanilla
+
+
+def tree_size(files):
+    return sum(os.path.getsize(f) for f in files)
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.split('\n')[0])
+    parser.add_argument('src', help='material data directory (eg. data/1.20.0/Android/Actor), or unpacked material with -f')
+    parser.add_argument('out', help='output directory')
+    parser.add_argument('-w', dest='whitelist', default='whitelist.json', help='whitelist (default whitelist.json)')
+    parser.add_argument('-m', dest='material', help='material name (default: name of src)')
+    parser.add_argument('-f', dest='vanilla', help='unpacked vanilla material, put the dropped variants back from it')
+    args = parser.parse_args()
+
+    material = args.material or os.path.basename(os.path.normpath(args.src))
+    with open(args.whitelist) as f:
+        rules = {k: v for k, v in json.load(f).items() if not k.startswith('_')}
+
+    if os.path.exists(args.out):
+        shutil.rmtree(args.out)
+    shutil.copytree(args.src, args.out)
+    rule = rules.get(material)
+    if rule is None:
+        return 0
+
+    if args.vanilla:
+        vanilla = {os.path.basename(path): (path, doc) for path, doc in data_json(args.vanilla)}
+        n_compiled = n_vanilla = 0
+        for path, doc in data_json(args.out):
+            name = os.path.basename(path)
+            if name not in vanilla:
+                print('Error: %s: %s not found in %s' % (material, name, args.vanilla))
+                return 1
+            vpath, vdoc = vanilla[name]
+            c, v = fallback(doc, vdoc, rule, os.path.dirname(vpath), os.path.dirname(path))
+            n_compiled += c
+            n_vanilla += v
+            with open(path, 'w') as f:
+                json.dump(doc, f, indent=2)
+        print('   - %s: %d compiled + %d vanilla variants' % (material, n_compiled, n_vanilla))
+        return 0
+
+    all_files = [os.path.join(r, n) for r, _, fs in os.walk(args.out) for n in fs]
+    size_before = tree_size(all_files)
+    before = after = 0
+    for path, doc in data_json(args.out):
+        b, a, dropped = prune(doc, rule)
+        before += b
+        after += a
+        if a == 0 and b > 0:
+            print('Error: %s: whitelist keeps no variant' % material)
+            return 1
+
+        # files only the dropped variants point to
+        base = os.path.dirname(path)
+        used = set(strings(doc))
+        for name in set(strings(dropped)) - used:
+            f = os.path.normpath(os.path.join(base, name))
+            if f.startswith(os.path.normpath(args.out)) and os.path.isfile(f):
+                os.remove(f)
+
+        with open(path, 'w') as f:
+            json.dump(doc, f, indent=2)
+
+    if before == 0:
+        print('   - %s: no passes found in %s, not pruned' % (material, args.src))
+        return 0
+    size_after = tree_size(os.path.join(r, n) for r, _, fs in os.walk(args.out) for n in fs)
+    print('   - %s: %d -> %d variants, data %d -> %d KB'
+          % (material, before, after, size_before//1024, size_after//1024))
+    return 0
+
+
+if __name__ == '__main__':
+    sys.exit(main())
@@ -0,0 +1,316 @@
+#!/usr/bin/env python3
+"""Static cost report for compiled GLSL/ESSL shaders.
+
+Walks a directory of unpacked material.bin files (see report.sh) laid out as
+<variant>/<material>/..., analyzes every GLSL text shader found and prints a
+table of estimated ALU ops, transcendental ops, texture fetches, branches,
+loop trip counts, varyings and temporaries per shader. The table can be saved
+as a baseline and later runs diffed against it.
+
+Counts are estimates from the optimized shader text: ALU counts operators and
+built-in calls (not vector width), loop bodies are weighted by their trip
+count when it is a compile time constant, temps is the number of scalar
+components of all local declarations (a proxy for register pressure).
+"""
+
+import argparse
+import os
+import re
+import sys
+
+TRANSCENDENTAL = {
+    'sin', 'cos', 'tan', 'asin', 'acos', 'atan', 'exp', 'exp2', 'log', 'log2',
+    'pow', 'sqrt', 'inversesqrt',
+}
+BUILTIN_ALU = {
+    'abs', 'sign', 'floor', 'ceil', 'fract', 'mod', 'min', 'max', 'clamp', 'mix',
+    'step', 'smoothstep', 'length', 'distance', 'dot', 'cross', 'normalize',
+    'reflect', 'refract', 'faceforward', 'dFdx', 'dFdy', 'fwidth', 'round',
+    'trunc', 'roundEven',
+}
+TEXTURE = {
+    'texture', 'textureLod', 'textureGrad', 'textureProj', 'texelFetch',
+    'textureOffset', 'textureLodOffset', 'texture2D', 'texture2DLod',
+    'texture2DLodEXT', 'texture2DGradEXT', 'texture2DProj', 'texture3D',
+    'texture3DLod', 'textureCube', 'textureCubeLod', 'shadow2D',
+    'shadow2DEXT',
+}
+TYPE_COMPONENTS = {
+    'float': 1, 'int': 1, 'uint': 1, 'bool': 1,
+    'vec2': 2, 'vec3': 3, 'vec4': 4,
+    'ivec2': 2, 'ivec3': 3, 'ivec4': 4,
+    'uvec2': 2, 'uvec3': 3, 'uvec4': 4,
+    'bvec2': 2, 'bvec3': 3, 'bvec4': 4,
+    'mat2': 4, 'mat3': 9, 'mat4': 16,
+}
+QUALIFIERS = {'highp', 'mediump', 'lowp', 'const', 'flat', 'smooth', 'centroid', 'noperspective', 'invariant'}
+
+ALU_OPERATORS = {'+', '-', '*', '/', '+=', '-=', '*=', '/=', '<', '>', '<=', '>=', '==', '!=', '&&', '||', '!'}
+METRICS = ('alu', 'trans', 'tex', 'branch', 'loops', 'trips', 'vary', 'vcomp', 'temps')
+DIFF_METRICS = ('alu', 'trans', 'tex', 'branch', 'trips', 'vcomp', 'temps')
+
+TOKEN_RE = re.compile(r'[A-Za-z_]\w*|\d+\.?\d*(?:[eE][-+]?\d+)?[fFuU]?|\.\d+(?:[eE][-+]?\d+)?[fF]?|'
+                      r'\+\+|--|[-+*/<>=!]=|&&|\|\||[{}()\[\];,?:.+\-*/<>=!&|^%~]')
+FOR_RE = re.compile(
+    r'for\s*\(\s*(?:(?:highp|mediump|lowp)\s+)?(?:int|uint)?\s*(\w+)\s*=\s*(-?\d+)[uU]?\s*;\s*'
+    r'\1\s*(<=|<|>=|>|!=)\s*(-?\d+)[uU]?\s*;\s*'
+    r'(\+\+\1|\1\+\+|--\1|\1--|\1\s*\+=\s*\d+|\1\s*-=\s*\d+)\s*\)')
+
+
+def strip_source(text):
+    text = re.sub(r'/\*.*?\*/', ' ', text, flags=re.S)
+    text = re.sub(r'//[^\n]*', '', text)
+    return '\n'.join(line for line in text.split('\n') if not line.lstrip().startswith('#'))
+
+
+def trip_count(start, op, end, step):
+    step = step.replace(' ', '')
+    if step.endswith('++') or step.startswith('++'):
+        inc = 1
+    elif step.endswith('--') or step.startswith('--'):
+        inc = -1
+    else:
+        inc = int(re.search(r'\d+', step).group(0)) * (-1 if '-=' in step else 1)
+    n = 0
+    i = start
+    while n < 4096 and {'<': i < end, '<=': i <= end, '>': i > end, '>=': i >= end, '!=': i != end}[op]:
+        i += inc
+        n += 1
+    return n
+
+
+def loop_multipliers(code, tokens, spans):
+    """Multiplier per token from the constant trip counts of enclosing loops."""
+    mult = [1] * len(tokens)
+    loops = 0
+    trips = 0
+    unknown = False
+    for m in re.finditer(r'\b(for|while)\b', code):
+        loops += 1
+        header = FOR_RE.match(code, m.start())
+        n = None
+        if header:
+            n = trip_count(int(header.group(2)), header.group(3), int(header.group(4)), header.group(5))
+            trips += n
+        else:
+            unknown = True
+
+        # body: next brace block after the loop header
+        body = code.find('{', m.end())
+        if body < 0 or n is None:
+            continue
+        depth = 0
+        end = body
+        for end in range(body, len(code)):
+            if code[end] == '{':
+                depth += 1
+            elif code[end] == '}':
+                depth -= 1
+                if depth == 0:
+                    break
+        for i, (start, _) in enumerate(spans):
+            if body < start < end:
+                mult[i] *= n
+    return mult, loops, ('%d?' % trips if unknown else trips)
+
+
+def analyze(text):
+    code = strip_source(text)
+    matches = list(TOKEN_RE.finditer(code))
+    tokens = [m.group(0) for m in matches]
+    spans = [m.span() for m in matches]
+    mult, loops, trips = loop_multipliers(code, tokens, spans)
+
+    stats = dict.fromkeys(METRICS, 0)
+    stats['loops'] = loops
+    stats['trips'] = trips
+    is_vertex = 'gl_Position' in tokens
+
+    depth = 0
+    for i, tok in enumerate(tokens):
+        nxt = tokens[i + 1] if i + 1 < len(tokens) else ''
+        prev = tokens[i - 1] if i > 0 else ''
+        w = mult[i]
+        if tok == '{':
+            depth += 1
+        elif tok == '}':
+            depth -= 1
+        elif nxt == '(' and tok in TRANSCENDENTAL:
+            stats['alu'] += w
+            stats['trans'] += w
+        elif nxt == '(' and tok in BUILTIN_ALU:
+            stats['alu'] += w
+        elif nxt == '(' and tok in TEXTURE:
+            stats['tex'] += w
+        elif tok in ('if', '?'):
+            stats['branch'] += w
+        elif tok in ALU_OPERATORS:
+            # unary minus/plus is usually a free source modifier
+            unary = tok in ('-', '+') and (prev in ALU_OPERATORS or prev in ('(', ',', '=', 'return', '?', ':', '['))
+            if not unary:
+                stats['alu'] += w
+        elif tok in TYPE_COMPONENTS and depth > 0 and re.match(r'[A-Za-z_]', nxt) and nxt not in QUALIFIERS:
+            # local declaration, including comma separated lists
+            comps = TYPE_COMPONENTS[tok]
+            j = i + 1
+            level = 0
+            while j < len(tokens) and not (tokens[j] == ';' and level == 0):
+                if tokens[j] in ('(', '['):
+                    level += 1
+                elif tokens[j] in (')', ']'):
+                    level -= 1
+                elif tokens[j] == ',' and level == 0:
+                    stats['temps'] += comps
+                j += 1
+            stats['temps'] += comps
+
+    # interface varyings at global scope
+    depth = 0
+    for line in code.split(';'):
+        if depth == 0:
+            words = [w for w in re.findall(r'\w+', line) if w not in QUALIFIERS]
+            if len(words) >= 3 and words[-2] in TYPE_COMPONENTS:
+                storage = words[-3]
+                if storage == 'varying' or (storage == 'out' and is_vertex) or (storage == 'in' and not is_vertex):
+                    if not words[-1].startswith(('a_', 'i_', 'gl_', 'bgfx_FragColor', 'bgfx_FragData')):
+                        stats['vary'] += 1
+                        stats['vcomp'] += TYPE_COMPONENTS[words[-2]]
+        depth += line.count('{') - line.count('}')
+
+    stats['stage'] = 'vertex' if is_vertex else 'fragment'
+    return stats
+
+
+def read_shader(path):
+    try:
+        with open(path, 'rb') as f:
+            data = f.read()
+        text = data.decode('utf-8')
+    except (OSError, UnicodeDecodeError):
+        return None
+    if 'void main' not in text:
+        return None
+    return text
+
+
+def collect(root):
+    rows = []
+    for dirpath, _, files in os.walk(root):
+        for name in sorted(files):
+            if name.endswith('.material.bin'):
+                continue
+            path = os.path.join(dirpath, name)
+            text = read_shader(path)
+            if text is None:
+                continue
+            rel = os.path.relpath(path, root).replace(os.sep, '/').split('/')
+            if len(rel) < 3:
+                continue
+            row = analyze(text)
+            row['variant'] = rel[0]
+            row['material'] = rel[1].split('.')[0]
+            row['shader'] = '/'.join(rel[2:])
+            rows.append(row)
+    rows.sort(key=lambda r: (r['variant'], r['material'], r['shader']))
+    return rows
+
+
+def row_key(row):
+    return '%s|%s|%s' % (row['variant'], row['material'], row['shader'])
+
+
+def write_table(rows, path):
+    with open(path, 'w') as f:
+        f.write('\t'.join(('variant', 'material', 'shader', 'stage') + METRICS) + '\n')
+        for r in rows:
+            f.write('\t'.join(str(r[k]) for k in ('variant', 'material', 'shader', 'stage') + METRICS) + '\n')
+
+
+def read_table(path):
+    rows = {}
+    with open(path) as f:
+        header = f.readline().rstrip('\n').split('\t')
+        for line in f:
+            row = dict(zip(header, line.rstrip('\n').split('\t')))
+            rows[row_key(row)] = row
+    return rows
+
+
+def number(value):
+    return int(str(value).rstrip('?'))
+
+
+def print_summary(rows):
+    """Worst permutation per variant, material and stage."""
+    summary = {}
+    for r in rows:
+        key = (r['variant'], r['material'], r['stage'])
+        best = summary.get(key)
+        if best is None or number(r['alu']) > number(best['alu']):
+            summary[key] = dict(r, count=(best['count'] + 1 if best else 1))
+        else:
+            best['count'] += 1
+
+    cols = ('alu', 'trans', 'tex', 'branch', 'trips', 'vary', 'vcomp', 'temps')
+    print('%-12s %-14s %-9s %5s ' % ('variant', 'material', 'stage', 'perms') + ' '.join('%7s' % c for c in cols))
+    for key in sorted(summary):
+        r = summary[key]
+        print('%-12s %-14s %-9s %5d ' % (key + (r['count'],)) + ' '.join('%7s' % r[c] for c in cols))
+
+
+def diff(rows, baseline, threshold):
+    regressions = 0
+    current = {row_key(r): r for r in rows}
+    for key in sorted(current):
+        r = current[key]
+        base = baseline.get(key)
+        if base is None:
+            print('  new      %s' % key.replace('|', ' '))
+            continue
+        changes = []
+        for m in DIFF_METRICS:
+            old, new = number(base[m]), number(r[m])
+            if old == new:
+                continue
+            pct = 100.0 * (new - old) / old if old else 100.0
+            changes.append('%s %d->%d (%+.1f%%)' % (m, old, new, pct))
+            if pct > threshold:
+                regressions += 1
+        if changes:
+            print('  changed  %s: %s' % (key.replace('|', ' '), ', '.join(changes)))
+    for key in sorted(set(baseline) - set(current)):
+        print('  removed  %s' % key.replace('|', ' '))
+    return regressions
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.split('\n')[0])
+    parser.add_argument('dir', help='unpacked materials, laid out as <variant>/<material>/...')
+    parser.add_argument('-o', dest='out', help='write the full table (tsv)')
+    parser.add_argument('-b', dest='baseline', help='diff against a saved table')
+    parser.add_argument('-t', dest='threshold', type=float, default=10.0,
+                        help='fail when a metric grows by more than this percentage (default 10)')
+    args = parser.parse_args()
+
+    rows = collect(args.dir)
+    if not rows:
+        print('Error: no GLSL shaders found in %s' % args.dir)
+        return 1
+
+    print_summary(rows)
+
+    if args.out:
+        write_table(rows, args.out)
+
+    if args.baseline:
+        print('\n>> Diff against %s (threshold %.1f%%)' % (args.baseline, args.threshold))
+        regressions = diff(rows, read_table(args.baseline), args.threshold)
+        if regressions:
+            print('>> %d metric(s) over threshold' % regressions)
+            return 2
+        print('>> No regressions')
+    return 0
+
+
+if __name__ == '__main__':
+    sys.exit(main())
@@ -0,0 +1,338 @@
+#!/usr/bin/env python3
+"""Pick the performance settings of device tier subpacks from a cost model.
+
+Resolves config.h (the default pack, or the subpack given with -s) like
+pack.sh does, and for every tier searches all combinations of the settings
+that decide the frame cost: cloud type and raymarch steps, glow leak, the
+plant, lantern, water and underwater waves, fog type, godray and the ground,
+aurora and water cloud reflections. Settings only go down from the resolved
+config, features it leaves off stay off; only the rounded cloud steps may
+rise, up to -m. The tier keeps the combination of the highest value
+(VALUES) whose cost fits its budget, ties go to the cheaper one, then to
+the one closer to the resolved config.
+
+The cost is of an average clear weather frame, per pixel, in the units of
+the cost heatmap (include/newb/functions/debug_cost.h, ns/call of the CPU
+bench), so a budget of NL_DEBUG_COST_SCALE is a frame that averages red.
+Per pixel work is weighted by the screen share of its surface, per vertex
+work of RenderChunk and Clouds by their vertices per pixel (SCENE). Weights
+are read from debug_cost.h, -b replaces them with measured ones: a bench.sh
+-o results file, or any "<name> <cost>" lines with the names of COSTS (eg.
+from instruction counts of the cost report).
+
+Prints the chosen settings, cost and value of every tier, and the config.h
+block and pack_config.sh entries of the tiers (-o writes them to a file).
+Tiers whose budget keeps the resolved config as it is are skipped.
+"""
+
+import argparse
+import itertools
+import math
+import os
+import re
+import sys
+
+from color_fit import resolve_config
+
+# average frame: screen share of the surfaces, vertices per pixel
+SCENE = {
+    'sky': 0.40,            # Sky pixels
+    'clouds': 0.15,         # Clouds pixels
+    'terrain': 0.45,        # RenderChunk pixels
+    'vertices': 0.25,       # RenderChunk vertices per pixel of the frame
+    'cloud_vertices': 0.01, # Clouds vertices per pixel of the frame
+    'water': 0.15,          # RenderChunk vertices on water
+    'up': 0.40,             # RenderChunk vertices facing up (ground reflection)
+    'plants': 0.20,         # RenderChunk vertices of plants
+    'lanterns': 0.01,       # RenderChunk vertices of lanterns and chains
+}
+
+# cost of one call, NL_COST_<name> of debug_cost.h where it has one
+COSTS = {
+    'TAP': 10.0,
+    'SKY': 50.0,
+    'STARS': 15.0,
+    'CLOUD_STEP': 75.0,
+    'CLOUD_REFL': 50.0,
+    'AURORA': 105.0,
+    'WATER': 125.0,
+    'REFL': 40.0,
+    'GODRAY': 35.0,
+    'WAVE': 80.0,
+    # not in the heatmap, estimated from the code
+    'SOFT_CLOUD': 250.0,    # renderCloudsSimple, two cloudNoise2D
+    'FOG_LINEAR': 2.0,      # NL_FOG_TYPE 1
+    'FOG_SMOOTH': 4.0,      # NL_FOG_TYPE 2, smoothstep
+    'FOG_EXP': 10.0,        # NL_FOG_TYPE 3, two exp
+    'WATER_WAVE': 2.0,
+    'UNDERWATER_WAVE': 5.0, # one sin
+}
+
+# bench.sh -o function names
+BENCH = {
+    'cloudDf': 'CLOUD_STEP',
+    'renderCloudsRefl': 'CLOUD_REFL',
+    'renderAurora': 'AURORA',
+    'nlRenderSky': 'SKY',
+    'nlFallingStars': 'STARS',
+    'nlWater': 'WATER',
+    'nlRefl': 'REFL',
+    'nlRenderGodRayIntensity': 'GODRAY',
+    'nlWave': 'WAVE',
+}
+
+# what keeping a setting is worth, rounded clouds add log2(steps/3)
+VALUES = {
+    'NL_CLOUD_TYPE': {0: 0.0, 1: 3.0, 2: 4.0},
+    'NL_GLOW_LEAK': 2.0,
+    'NL_PLANTS_WAVE': 2.0,
+    'NL_LANTERN_WAVE': 1.0,
+    'NL_WATER_WAVE': 1.0,
+    'NL_UNDERWATER_WAVE': 1.0,
+    'NL_FOG_TYPE': {0: 0.0, 1: 1.0, 2: 1.5, 3: 2.0},
+    'NL_GODRAY': 2.0,
+    'NL_GROUND_REFL': 2.0,
+    'NL_GROUND_AURORA_REFL': 1.0,
+    'NL_WATER_CLOUD_REFLECTION': 1.0,
+}
+TOGGLES = ['NL_GLOW_LEAK', 'NL_PLANTS_WAVE', 'NL_LANTERN_WAVE', 'NL_WATER_WAVE', 'NL_UNDERWATER_WAVE',
+           'NL_GODRAY', 'NL_GROUND_REFL', 'NL_GROUND_AURORA_REFL', 'NL_WATER_CLOUD_REFLECTION']
+STEPS = [3, 4, 5, 7, 9, 12, 16]
+# settings that change the Clouds material, all others only RenderChunk
+CLOUD_SETTINGS = ('NL_CLOUD_TYPE', 'NL_CLOUD2_STEPS')
+
+
+def read_debug_cost(path):
+    costs = {}
+    with open(path) as f:
+        for m in re.finditer(r'^#define\s+NL_COST_(\w+)\s+([\d.]+)', f.read(), flags=re.M):
+            costs[m.group(1)] = float(m.group(2))
+    return costs
+
+
+def read_weights(path):
+    """bench.sh -o results or "<name> <cost>" lines, by COSTS name."""
+    costs = {}
+    with open(path) as f:
+        for line in f:
+            fields = line.split()
+            if len(fields) != 2:
+                continue
+            name = fields[0][len('NL_COST_'):] if fields[0].startswith('NL_COST_') else fields[0]
+            name = BENCH.get(name, name)
+            if name in COSTS:
+                costs[name] = float(fields[1])
+    return costs
+
+
+def candidates(macros, max_steps):
+    """Levels of every setting, from the resolved config down."""
+    cloud_type = int(macros.get('NL_CLOUD_TYPE', '0'))
+    if cloud_type not in VALUES['NL_CLOUD_TYPE']:
+        sys.exit('Error: NL_CLOUD_TYPE %d has no Clouds renderer to tune' % cloud_type)
+    clouds = [(t, None) for t in range(min(cloud_type, 1) + 1)]
+    if cloud_type == 2:
+        steps = int(macros.get('NL_CLOUD2_STEPS', '0'))
+        clouds += [(2, s) for s in sorted(set(s for s in STEPS if s <= max(steps, max_steps)) | {steps})]
+
+    fog_type = int(macros.get('NL_FOG_TYPE', '0'))
+    fogs = [0] + ([fog_type] if fog_type else [])
+    toggles = [[False, True] if name in macros else [False] for name in TOGGLES]
+    return clouds, fogs, toggles
+
+
+def frame_cost(s, w, macros):
+    """Cost per pixel of the average frame with settings s and weights w."""
+    aurora = 'NL_AURORA' in macros
+    cost = SCENE['sky']*(w['SKY'] + (w['STARS'] if 'NL_FALLING_STARS' in macros else 0.0))
+
+    if s['NL_CLOUD_TYPE'] == 2:
+        cost += SCENE['clouds']*(s['NL_CLOUD2_STEPS']*w['CLOUD_STEP'] + (w['AURORA'] if aurora else 0.0))
+    elif s['NL_CLOUD_TYPE'] == 1:
+        cost += SCENE['cloud_vertices']*(w['SOFT_CLOUD'] + (w['AURORA'] if aurora else 0.0))
+
+    if s['NL_GLOW_LEAK'] and 'NL_GLOW_BAKED' not in macros:
+        cost += SCENE['terrain']*8.0*w['TAP']
+
+    vertex = 0.0
+    vertex += {0: 0.0, 1: w['FOG_LINEAR'], 2: w['FOG_SMOOTH'], 3: w['FOG_EXP']}.get(s['NL_FOG_TYPE'], 0.0)
+    if s['NL_GODRAY']:
+        vertex += w['GODRAY']
+    if s['NL_UNDERWATER_WAVE']:
+        vertex += w['UNDERWATER_WAVE']
+    if s['NL_PLANTS_WAVE']:
+        vertex += SCENE['plants']*w['WAVE']
+    if s['NL_LANTERN_WAVE']:
+        vertex += SCENE['lanterns']*w['WAVE']
+
+    water = w['WATER'] + (w['WATER_WAVE'] if s['NL_WATER_WAVE'] else 0.0)
+    if s['NL_WATER_CLOUD_REFLECTION']:
+        water += {2: w['CLOUD_REFL'], 1: w['SOFT_CLOUD']}.get(s['NL_CLOUD_TYPE'], 0.0)
+        water += w['AURORA'] if aurora else 0.0
+    vertex += SCENE['water']*water
+
+    # clear weather: without NL_GROUND_REFL only rain makes the ground reflect
+    if s['NL_GROUND_REFL']:
+        refl = w['REFL'] + (w['AURORA'] if s['NL_GROUND_AURORA_REFL'] and aurora else 0.0)
+        vertex += SCENE['up']*refl
+    return cost + SCENE['vertices']*vertex
+
+
+def value(s, macros):
+    v = VALUES['NL_CLOUD_TYPE'][s['NL_CLOUD_TYPE']]
+    if s['NL_CLOUD_TYPE'] == 2:
+        v += math.log2(s['NL_CLOUD2_STEPS']/3.0)
+    v += VALUES['NL_FOG_TYPE'].get(s['NL_FOG_TYPE'], 0.0)
+    for name in TOGGLES:
+        # aurora reflection needs the ground reflection and aurora
+        if name == 'NL_GROUND_AURORA_REFL' and not (s['NL_GROUND_REFL'] and 'NL_AURORA' in macros):
+            continue
+        if s[name]:
+            v += VALUES[name]
+    return v
+
+
+def search(macros, w, budget, max_steps):
+    """Settings of the highest value within budget, and their cost and value."""
+    base = base_settings(macros)
+    clouds, fogs, toggles = candidates(macros, max_steps)
+    best = None
+    for (cloud_type, steps), fog, flags in itertools.product(clouds, fogs, itertools.product(*toggles)):
+        s = dict(zip(TOGGLES, flags))
+        s.update(NL_CLOUD_TYPE=cloud_type, NL_CLOUD2_STEPS=steps, NL_FOG_TYPE=fog)
+        cost = frame_cost(s, w, macros)
+        if cost > budget:
+            continue
+        # settings without cost or value (eg. aurora reflection without ground reflection) stay as they are
+        key = (round(value(s, macros), 6), -round(cost, 6), sum(s[k] == base[k] for k in s))
+        if best is None or key > best[0]:
+            best = (key, s, cost)
+    if best is None:
+        return None, None, None
+    return best[1], best[2], best[0][0]
+
+
+def base_settings(macros):
+    s = {name: name in macros for name in TOGGLES}
+    s['NL_CLOUD_TYPE'] = int(macros.get('NL_CLOUD_TYPE', '0'))
+    s['NL_CLOUD2_STEPS'] = int(macros['NL_CLOUD2_STEPS']) if s['NL_CLOUD_TYPE'] == 2 else None
+    s['NL_FOG_TYPE'] = int(macros.get('NL_FOG_TYPE', '0'))
+    return s
+
+
+def block(option, s, base, macros, cost, budget):
+    """config.h block of a tier: settings that differ from the resolved config."""
+    lines = ['#ifdef %s' % option, '  // tools/tier_tune.py: cost %.0f of %.0f' % (cost, budget)]
+    for name in ('NL_CLOUD_TYPE', 'NL_CLOUD2_STEPS', 'NL_FOG_TYPE') + tuple(TOGGLES):
+        if s[name] == base[name] or (name == 'NL_CLOUD2_STEPS' and s[name] is None):
+            continue
+        lines.append('  #undef %s' % name)
+        if name in TOGGLES:
+            continue
+        lines.append('  #define %s %d' % (name, s[name]))
+    lines.append('#endif')
+    return lines
+
+
+def describe(s, base):
+    kept = []
+    for name in TOGGLES:
+        if base[name]:
+            kept.append(('' if s[name] else '-') + name[3:].lower())
+    clouds = {0: 'vanilla', 1: 'soft', 2: 'rounded'}[s['NL_CLOUD_TYPE']]
+    if s['NL_CLOUD2_STEPS']:
+        clouds += ' %d' % s['NL_CLOUD2_STEPS']
+    return 'clouds %s, fog %d, %s' % (clouds, s['NL_FOG_TYPE'], ' '.join(kept))
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.split('\n')[0])
+    parser.add_argument('config', help='config.h (eg. include/newb/config.h)')
+    parser.add_argument('tiers', nargs='+', metavar='OPTION=BUDGET[:name]',
+                        help='subpack option, frame cost budget and subpack name (eg. LOW=100:low)')
+    parser.add_argument('-s', dest='option', default='default',
+                        help='subpack option whose config the tiers start from (default: the default pack)')
+    parser.add_argument('-c', dest='debug_cost', default='include/newb/functions/debug_cost.h',
+                        help='cost weights (default include/newb/functions/debug_cost.h)')
+    parser.add_argument('-b', dest='weights', help='measured weights, bench.sh -o results or "<name> <cost>" lines')
+    parser.add_argument('-m', dest='max_steps', type=int, default=16,
+                        help='most rounded cloud steps a tier may raise to (default 16)')
+    parser.add_argument('-o', dest='out', help='write the config.h blocks and pack_config.sh entries')
+    args = parser.parse_args()
+
+    if not os.path.isfile(args.config):
+        sys.exit('Error: %s not found' % args.config)
+
+    weights = dict(COSTS)
+    if os.path.isfile(args.debug_cost):
+        weights.update((k, v) for k, v in read_debug_cost(args.debug_cost).items() if k in COSTS)
+    else:
+        print('Warning: %s not found, using built-in weights' % args.debug_cost)
+    if args.weights:
+        measured = read_weights(args.weights)
+        if not measured:
+            sys.exit('Error: no known weights in %s' % args.weights)
+        weights.update(measured)
+
+    tiers = []
+    for spec in args.tiers:
+        m = re.match(r'(\w+)=([\d.]+)(?::(.+))?$', spec)
+        if not m:
+            sys.exit('Error: bad tier %s, expected OPTION=BUDGET[:name]' % spec)
+        tiers.append((m.group(1).upper(), float(m.group(2)), m.group(3) or m.group(1).lower()))
+
+    macros = resolve_config(args.config, args.option)
+    base = base_settings(macros)
+    print('%-12s %8s %8s %6s  %s' % ('tier', 'budget', 'cost', 'value', 'settings'))
+    print('%-12s %8s %8.1f %6.2f  %s' % (args.option, '', frame_cost(base, weights, macros),
+                                         value(base, macros), describe(base, base)))
+
+    blocks = []
+    entries = []
+    errors = 0
+    for option, budget, name in tiers:
+        s, cost, v = search(macros, weights, budget, args.max_steps)
+        if s is None:
+            print('%-12s %8.0f %8s %6s  nothing fits' % (option, budget, '-', '-'))
+            errors += 1
+            continue
+        # a subpack identical to its parent would only add a copy of it
+        if s == base:
+            print('%-12s %8.0f %8.1f %6.2f  same as %s, skipped' % (option, budget, cost, v, args.option))
+            continue
+        print('%-12s %8.0f %8.1f %6.2f  %s' % (option, budget, cost, v, describe(s, base)))
+        blocks.append(block(option, s, base, macros, cost, budget))
+        changed = set(k for k in s if s[k] != base[k])
+        materials = []
+        if changed & set(CLOUD_SETTINGS):
+            materials.append('Clouds')
+        # the water cloud reflection renders the tier's clouds too
+        if changed - set(CLOUD_SETTINGS) or (materials and s['NL_WATER_CLOUD_REFLECTION']):
+            materials.append('RenderChunk')
+        materials = ' ; '.join(materials)
+        entries.append((option, name, materials))
+
+    if not blocks:
+        return 1 if errors else 0
+
+    lines = ['/* tiers of tools/tier_tune.py from %s (%s) */' % (args.option, ' '.join(args.tiers))]
+    for b in blocks:
+        lines += b + ['']
+    lines += [
+        '# pack_config.sh',
+        'SUBPACK_OPTIONS+=(%s)' % ' '.join(o for o, _, _ in entries),
+        'SUBPACK_NAMES+=(%s)' % ' '.join('"%s"' % n for _, n, _ in entries),
+        'SUBPACK_MATERIALS+=(%s)' % ' '.join('"%s"' % m for _, _, m in entries),
+    ]
+    print('')
+    if args.out:
+        with open(args.out, 'w') as f:
+            f.write('\n'.join(lines) + '\n')
+        print('wrote %s' % args.out)
+    else:
+        print('\n'.join(lines))
+    return 0
+
+
+if __name__ == '__main__':
+    sys.exit(main())